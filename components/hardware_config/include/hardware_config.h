@@ -33,10 +33,17 @@
 #define HW_I2C_SDA_PIN 1
 #define HW_I2C_SCL_PIN 2
 
+// DS3231 INT/SQW pin (open-drain, active low) for alarm wakeup
+// Must be an RTC-capable GPIO (0-21 on ESP32-S3)
+#define HW_RTC_INT_PIN 4
+
 // ============================================================================
 // Weather Behavior Configuration
 // ============================================================================
 
+// Hour when the control pin turns on each day (24h format)
+#define HW_PIN_ON_HOUR 9  // 9 AM
+
 // Hour to check weather forecast (24h format)
 #define HW_WEATHER_CHECK_HOUR 16  // 4 PM
 
@@ -44,6 +51,29 @@
 #define HW_DEFAULT_LATITUDE  52.23
 #define HW_DEFAULT_LONGITUDE 21.01
 
+// ============================================================================
+// Wake Schedule Configuration
+// ============================================================================
+// The device does not wake every hour. Before deep sleep it computes the next
+// hour at which something actually happens and sleeps straight to it:
+// - HW_PIN_ON_HOUR (control pin and LEDs turn on)
+// - pin_off_hour (control pin and LEDs turn off, from the cloudcover ranges)
+// - HW_WEATHER_CHECK_HOUR (weather forecast fetch)
+// - Log upload deadline (see HW_LOG_UPLOAD_INTERVAL_HOURS)
+
+// Second within the target hour to wake at (buffer for deep sleep timer inaccuracy)
+#define HW_WAKE_TARGET_SECOND 30
+
+// Wake on DS3231 Alarm 1 instead of the internal sleep timer
+// Requires the DS3231 INT/SQW pin wired to HW_RTC_INT_PIN. The alarm fires exactly
+// at HH:00:00, so no HW_WAKE_TARGET_SECOND buffer or wait is needed. The sleep
+// timer stays armed HW_RTC_ALARM_BACKUP_SECONDS later as a backup.
+#define HW_RTC_ALARM_WAKE_ENABLED false
+#define HW_RTC_ALARM_BACKUP_SECONDS 120
+
+// Maximum hours between remote log uploads (0 = only upload on other events)
+#define HW_LOG_UPLOAD_INTERVAL_HOURS 6
+
 // ============================================================================
 // Timezone Configuration
 // ============================================================================
@@ -58,6 +88,86 @@
 // RTC storage format: UTC (all times stored in RTC are UTC)
 // User-facing times: Local time (CET/CEST) with automatic DST adjustment
 
+// ============================================================================
+// WiFi Connection Configuration
+// ============================================================================
+
+// Reconnect to the last AP directly (cached BSSID and channel, no channel scan)
+// and reuse its DHCP lease (IP, gateway, netmask, DNS) as a static IP.
+// The cache lives in RTC memory. If the cached AP cannot be reached, the
+// connection falls back to a full scan and DHCP.
+#define HW_WIFI_FAST_CONNECT_ENABLED true
+
+// Age in hours after which a cached lease is no longer reused and DHCP runs again
+// to renew it. Keep this at most half the router's DHCP lease time (when a DHCP
+// client would renew it); 6 h suits the common 12-24 h lease times
+#define HW_WIFI_LEASE_REUSE_MAX_HOURS 6
+
+// Radio-on time budget per wake for connecting, including retries (milliseconds)
+// Disconnects are retried with backoff depending on the reason (wrong password
+// gives up at once) until the budget is spent
+#define HW_WIFI_RADIO_BUDGET_MS 8000
+
+// PHY/RF calibration is reused across deep sleep until the chip temperature
+// moved more than HW_PHY_CAL_MAX_TEMP_DELTA_C (degrees C) or the calibration is
+// older than HW_PHY_CAL_MAX_AGE_HOURS; then a full calibration runs and is stored.
+// Only the temperature and time of the calibration are kept in RTC memory; the
+// calibration data stays in NVS, where PHY init loads it from. IDF has no public
+// hook to feed it from RAM, and the ~2 KB blob would not fit next to the log buffer.
+#define HW_PHY_CAL_MAX_TEMP_DELTA_C 10
+#define HW_PHY_CAL_MAX_AGE_HOURS 72
+
+// After this many wakes in a row fail to connect, WiFi is only started again for
+// the weather fetch; logs stay buffered in RTC memory meanwhile (0 = no limit)
+#define HW_WIFI_MAX_FAILED_WAKES 3
+
+// ============================================================================
+// Weather Fetch Configuration
+// ============================================================================
+
+// Resume the TLS session of the previous forecast fetch (abbreviated handshake:
+// no certificate chain, verification or key exchange). The serialized session
+// is kept in RTC memory; sessions larger than HW_TLS_SESSION_CACHE_SIZE bytes
+// are not cached (needs CONFIG_MBEDTLS_SSL_KEEP_PEER_CERTIFICATE disabled)
+#define HW_TLS_SESSION_RESUMPTION_ENABLED true
+#define HW_TLS_SESSION_CACHE_SIZE 512
+
+// Request the forecast gzip-compressed (about a third of the bytes over the air)
+// and inflate it chunk by chunk into the parser; needs ~43 KB heap while fetching
+#define HW_GZIP_RESPONSE_ENABLED true
+
+// Bump arena for the working memory of a fetch (TLS connection state and the
+// ~43 KB gzip decoder): one heap block allocated per request and freed after it
+#define HW_FETCH_ARENA_SIZE (48 * 1024)
+
+// Request the forecast as CSV instead of JSON (same values without key names
+// and quoting: ~25% fewer bytes and less parsing); both formats are supported
+#define HW_FORECAST_FORMAT_CSV true
+
+// Days from tomorrow on kept in RTC memory (~40 bytes per day). The request
+// asks for today plus these days (forecast_days), so its URL is the same every
+// day and the validators of the cached response (ETag/Last-Modified) can be
+// replayed for a 304 Not Modified; a failed fetch falls back to the cached
+// day. Maximum 7 (FORECAST_CACHE_DAYS)
+#define HW_FORECAST_CACHE_DAYS 7
+
+// A cached forecast for tomorrow younger than this is used without bringing
+// up WiFi for the fetch (0 = always fetch, the cache is then only a fallback)
+#define HW_FORECAST_CACHE_MAX_AGE_HOURS 30
+
+// Fetch the forecast through the log server's caching proxy (tools/log_server,
+// WEATHER_PROXY_URL in config.h) over plain LAN HTTP: no TLS handshake on the
+// device and one upstream request per site. Falls back to Open-Meteo if the
+// proxy does not answer
+#define HW_WEATHER_PROXY_ENABLED false
+
+// Ask the log server for the finished decision instead of a forecast
+// (WEATHER_DECISION_URL in config.h): a 32-byte record with tomorrow's
+// pin-off hour, LED count and hourly cloud cover, computed by the server from
+// the HW_CLOUDCOVER_RANGES above. Falls back to the forecast fetch if the
+// server does not answer or the record is corrupt
+#define HW_WEATHER_DECISION_ENABLED false
+
 // ============================================================================
 // Remote Logging Configuration
 // ============================================================================
@@ -69,6 +179,18 @@
 // Each message uses ~150 bytes, so 100 messages = ~15KB RAM
 #define HW_LOG_BUFFER_SIZE 100
 
+// Number of log messages kept in RTC memory across deep sleep when a wake
+// skips WiFi (each message uses ~170 bytes of the 8 KB RTC slow memory, see
+// HW_RTC_BUDGET_LOG_RETAINED)
+#define HW_LOG_RETAINED_SIZE 20
+
+// WiFi is brought up to flush logs only when one of these holds:
+// - The weather fetch is due
+// - At least HW_LOG_FLUSH_HIGH_WATER messages are buffered
+// - An ERROR message is buffered
+// - HW_LOG_UPLOAD_INTERVAL_HOURS have passed since the last upload
+#define HW_LOG_FLUSH_HIGH_WATER HW_LOG_RETAINED_SIZE
+
 // Device identifier for remote logging (helps distinguish multiple devices)
 #define HW_LOG_DEVICE_NAME "weather-esp32"
 
@@ -91,6 +213,36 @@
 // - Resulting pin_off_hour and LED count
 #define HW_WEATHER_DIAGNOSTICS_ENABLED true
 
+// ============================================================================
+// Wake Profiler Configuration
+// ============================================================================
+
+// Enable/disable per-phase timing of each wake cycle
+// When enabled, every phase of app_main (timezone init, I2C init, WiFi connect,
+// weather fetch, log flush, ...) is timed with esp_timer. Per-phase min/avg/max
+// statistics are kept in RTC memory across deep sleep and attached to the next
+// weather diagnostics upload, after which they start accumulating again.
+// The WiFi, fetch and flush tasks also report their smallest unused stack.
+#define HW_WAKE_PROFILER_ENABLED true
+
+// ============================================================================
+// Power Management Configuration
+// ============================================================================
+
+// Enable/disable the power management profile (needs CONFIG_PM_ENABLE)
+// When enabled, the CPU runs at HW_PM_MAX_FREQ_MHZ only during TLS and JSON
+// work, at HW_PM_MIN_FREQ_MHZ while waiting on the network or the clock, and
+// enters automatic light sleep when all tasks are blocked. Time spent in each
+// state is attached to the weather diagnostics upload.
+#define HW_POWER_PROFILE_ENABLED true
+
+// CPU frequency for compute work and while waiting (MHz: 240, 160, 80, 40)
+#define HW_PM_MAX_FREQ_MHZ 240
+#define HW_PM_MIN_FREQ_MHZ 40
+
+// Enter light sleep automatically when idle (needs CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+#define HW_PM_LIGHT_SLEEP_ENABLED true
+
 // ============================================================================
 // Built-in RGB LED Configuration
 // ============================================================================
@@ -115,6 +267,30 @@
 // Default: 30% (medium brightness, clearly visible but not too bright)
 #define HW_RGB_LED_BRIGHTNESS 30
 
+// ============================================================================
+// RTC Memory Budget
+// ============================================================================
+
+// Everything kept across deep sleep (RTC_DATA_ATTR) shares the 8 KB of RTC slow
+// memory with the IDF's own RTC data and the ULP reserve. Each component checks
+// its RTC variables against its share below with a _Static_assert, so growing
+// one (HW_LOG_RETAINED_SIZE, HW_TLS_SESSION_CACHE_SIZE, a new field) fails the
+// build with the name of the component instead of overflowing rtc_slow_seg at
+// link time. The shares leave room for alignment between variables; their sum
+// must stay within HW_RTC_SLOW_MEM_BUDGET, which keeps 1 KB for the IDF
+#define HW_RTC_SLOW_MEM_BUDGET (7 * 1024)
+#define HW_RTC_BUDGET_LOG_RETAINED 3584     // remote_logging: retained messages (20 x 172 B)
+#define HW_RTC_BUDGET_TLS_SESSION 640       // https_stream: serialized TLS session (~564 B)
+#define HW_RTC_BUDGET_FORECAST_CACHE 448    // weather_fetch: 7-day forecast cache (~384 B)
+#define HW_RTC_BUDGET_WIFI 192              // wifi_helper: AP and fast-connect caches, PHY calibration, failed wakes
+#define HW_RTC_BUDGET_WAKE_PROFILER 320     // wake_profiler: per-phase statistics (~288 B)
+#define HW_RTC_BUDGET_POWER_PROFILE 64      // power_profile: time per power state (~32 B)
+#define HW_RTC_BUDGET_MAIN 128              // main: applied outputs, sleep drift and timing, upload state
+
+_Static_assert(HW_RTC_BUDGET_LOG_RETAINED + HW_RTC_BUDGET_TLS_SESSION + HW_RTC_BUDGET_FORECAST_CACHE +
+               HW_RTC_BUDGET_WIFI + HW_RTC_BUDGET_WAKE_PROFILER + HW_RTC_BUDGET_POWER_PROFILE +
+               HW_RTC_BUDGET_MAIN <= HW_RTC_SLOW_MEM_BUDGET, "RTC memory shares exceed HW_RTC_SLOW_MEM_BUDGET");
+
 // ============================================================================
 // Cloud Cover Ranges Configuration
 // ============================================================================
@@ -0,0 +1,86 @@
+#ifndef POWER_PROFILE_H
+#define POWER_PROFILE_H
+
+#include "hardware_config.h"
+#include "esp_err.h"
+#include <stddef.h>
+
+/**
+ * @file power_profile.h
+ * @brief CPU frequency and light sleep profile for the wake cycle
+ *
+ * Configures ESP-IDF power management so the CPU idles at HW_PM_MIN_FREQ_MHZ
+ * (and enters automatic light sleep when every task is blocked) while waiting
+ * on the network or the clock. CPU-heavy work (TLS handshakes, JSON building
+ * and parsing) is bracketed with power_profile_compute_begin()/end(), which
+ * holds a PM lock for HW_PM_MAX_FREQ_MHZ.
+ *
+ * Time spent at max frequency, at low frequency and in light sleep is summed
+ * per wake and accumulated in RTC memory until it is shipped with the weather
+ * diagnostics upload, like the wake profiler statistics.
+ *
+ * Requires CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE; light sleep
+ * time is only counted with CONFIG_PM_LIGHT_SLEEP_CALLBACKS.
+ */
+
+// Only compile power profile functions if the feature is enabled
+#if HW_POWER_PROFILE_ENABLED
+
+/**
+ * @brief Configure power management and create the compute lock
+ *
+ * Call early in app_main, before the first long wait.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if CONFIG_PM_ENABLE is off
+ */
+esp_err_t power_profile_init(void);
+
+/**
+ * @brief Run at max CPU frequency until the matching power_profile_compute_end()
+ *
+ * Calls may nest and may come from several tasks at once.
+ */
+void power_profile_compute_begin(void);
+
+/**
+ * @brief Release the max CPU frequency request from power_profile_compute_begin()
+ */
+void power_profile_compute_end(void);
+
+/**
+ * @brief Fold this wake's time per state into the statistics and log it
+ *
+ * Should be called right before entering deep sleep.
+ */
+void power_profile_finish_wake(void);
+
+/**
+ * @brief Serialize accumulated statistics as a JSON object
+ *
+ * Format: {"wakes":N,"max_freq_ms":..,"low_freq_ms":..,"light_sleep_ms":..}
+ * Times are averages per wake.
+ *
+ * @param buf Output buffer
+ * @param size Size of output buffer in bytes
+ * @return Number of characters written (excluding terminator), or -1 if buffer too small
+ */
+int power_profile_to_json(char *buf, size_t size);
+
+/**
+ * @brief Clear accumulated statistics (call after they have been shipped)
+ */
+void power_profile_reset(void);
+
+#else
+
+// Stub functions when the power profile is disabled (compile to nothing)
+static inline esp_err_t power_profile_init(void) { return ESP_OK; }
+static inline void power_profile_compute_begin(void) { }
+static inline void power_profile_compute_end(void) { }
+static inline void power_profile_finish_wake(void) { }
+static inline int power_profile_to_json(char *buf, size_t size) { if (buf && size) buf[0] = '\0'; return 0; }
+static inline void power_profile_reset(void) { }
+
+#endif // HW_POWER_PROFILE_ENABLED
+
+#endif // POWER_PROFILE_H
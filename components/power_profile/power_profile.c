@@ -0,0 +1,149 @@
+#include "power_profile.h"
+
+// Only compile this code if the power profile is enabled
+#if HW_POWER_PROFILE_ENABLED
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "POWER_PROFILE";
+
+// Accumulated time per state over consecutive wakes (microseconds)
+typedef struct {
+    uint32_t wakes;
+    uint64_t max_freq_us;
+    uint64_t low_freq_us;
+    uint64_t light_sleep_us;
+} power_stats_t;
+
+// RTC memory statistics persist during deep sleep (zeroed on power-on)
+RTC_DATA_ATTR static power_stats_t s_stats;
+
+_Static_assert(sizeof(s_stats) <= HW_RTC_BUDGET_POWER_PROFILE, "Power statistics exceed HW_RTC_BUDGET_POWER_PROFILE");
+
+// Per-wake state (regular RAM, reset on every boot)
+static esp_pm_lock_handle_t s_compute_lock = NULL;
+static portMUX_TYPE s_compute_mux = portMUX_INITIALIZER_UNLOCKED;
+static int s_compute_depth = 0;
+static int64_t s_compute_start_us = 0;
+static int64_t s_max_freq_us = 0;
+static volatile int64_t s_light_sleep_us = 0;
+
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+// Runs from the idle task with interrupts disabled; only adds up the slept time
+static esp_err_t IRAM_ATTR light_sleep_exit_cb(int64_t sleep_time_us, void *arg) {
+    (void)arg;
+    s_light_sleep_us += sleep_time_us;
+    return ESP_OK;
+}
+#endif
+
+esp_err_t power_profile_init(void) {
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = HW_PM_MAX_FREQ_MHZ,
+        .min_freq_mhz = HW_PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = HW_PM_LIGHT_SLEEP_ENABLED,
+    };
+
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Power management not configured: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    if (s_compute_lock == NULL) {
+        err = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "compute", &s_compute_lock);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to create compute PM lock: %s", esp_err_to_name(err));
+            return err;
+        }
+    }
+
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs = {
+        .exit_cb = light_sleep_exit_cb,
+    };
+    esp_pm_light_sleep_register_cbs(&cbs);
+#endif
+
+    ESP_LOGI(TAG, "CPU %d MHz for compute, %d MHz while waiting, light sleep %s",
+             HW_PM_MAX_FREQ_MHZ, HW_PM_MIN_FREQ_MHZ, HW_PM_LIGHT_SLEEP_ENABLED ? "on" : "off");
+    return ESP_OK;
+}
+
+void power_profile_compute_begin(void) {
+    if (s_compute_lock != NULL) {
+        esp_pm_lock_acquire(s_compute_lock);
+    }
+
+    portENTER_CRITICAL(&s_compute_mux);
+    if (s_compute_depth++ == 0) {
+        s_compute_start_us = esp_timer_get_time();
+    }
+    portEXIT_CRITICAL(&s_compute_mux);
+}
+
+void power_profile_compute_end(void) {
+    portENTER_CRITICAL(&s_compute_mux);
+    if (s_compute_depth > 0 && --s_compute_depth == 0) {
+        s_max_freq_us += esp_timer_get_time() - s_compute_start_us;
+    }
+    portEXIT_CRITICAL(&s_compute_mux);
+
+    if (s_compute_lock != NULL) {
+        esp_pm_lock_release(s_compute_lock);
+    }
+}
+
+void power_profile_finish_wake(void) {
+    // esp_timer keeps counting through light sleep, so this is the whole wake
+    int64_t awake_us = esp_timer_get_time();
+    int64_t light_sleep_us = s_light_sleep_us;
+    int64_t low_freq_us = awake_us - s_max_freq_us - light_sleep_us;
+    if (low_freq_us < 0) {
+        low_freq_us = 0;
+    }
+
+    s_stats.wakes++;
+    s_stats.max_freq_us += s_max_freq_us;
+    s_stats.low_freq_us += low_freq_us;
+    s_stats.light_sleep_us += light_sleep_us;
+
+    ESP_LOGI(TAG, "Max freq %lld ms, low freq %lld ms, light sleep %lld ms",
+             s_max_freq_us / 1000, low_freq_us / 1000, light_sleep_us / 1000);
+}
+
+int power_profile_to_json(char *buf, size_t size) {
+    if (!buf || size == 0) {
+        return -1;
+    }
+
+    uint32_t wakes = s_stats.wakes ? s_stats.wakes : 1;
+    int len = snprintf(buf, size,
+                       "{\"wakes\":%lu,\"max_freq_ms\":%lu,\"low_freq_ms\":%lu,\"light_sleep_ms\":%lu}",
+                       (unsigned long)s_stats.wakes,
+                       (unsigned long)(s_stats.max_freq_us / wakes / 1000),
+                       (unsigned long)(s_stats.low_freq_us / wakes / 1000),
+                       (unsigned long)(s_stats.light_sleep_us / wakes / 1000));
+
+    if (len < 0 || (size_t)len >= size) {
+        ESP_LOGW(TAG, "Power profile JSON truncated (buffer %u bytes)", (unsigned)size);
+        buf[0] = '\0';
+        return -1;
+    }
+    return len;
+}
+
+void power_profile_reset(void) {
+    memset(&s_stats, 0, sizeof(s_stats));
+    ESP_LOGI(TAG, "Power profile statistics reset");
+}
+
+#endif // HW_POWER_PROFILE_ENABLED
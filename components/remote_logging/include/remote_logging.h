@@ -16,6 +16,7 @@
  * - Each log includes timestamp from RTC
  * - Thread-safe operations
  * - Tracks dropped messages
+ * - Unsent messages survive deep sleep in RTC memory (newest HW_LOG_RETAINED_SIZE)
  * - Graceful degradation if server unavailable
  */
 
@@ -38,6 +39,9 @@ esp_err_t remote_logging_init(void);
  * If server is unreachable, logs remain in buffer and will be retried on next flush.
  * If buffer overflows between flushes, oldest messages are dropped (FIFO).
  *
+ * The buffer is only locked while the payload is built, so other tasks can keep
+ * logging during the upload; their messages stay buffered for the next flush.
+ *
  * @return ESP_OK if logs sent successfully, ESP_FAIL if server unreachable or HTTP error
  */
 esp_err_t remote_logging_flush(void);
@@ -58,6 +62,24 @@ int remote_logging_get_buffered_count(void);
  */
 int remote_logging_get_dropped_count(void);
 
+/**
+ * @brief Check whether an ERROR message is waiting in the buffer
+ *
+ * @return true if at least one buffered message has ERROR level
+ */
+bool remote_logging_has_errors(void);
+
+/**
+ * @brief Keep unsent messages in RTC memory across deep sleep
+ *
+ * Copies the newest HW_LOG_RETAINED_SIZE buffered messages to RTC memory so
+ * remote_logging_init() can restore them on the next wake. Older messages are
+ * added to the dropped counter. Call right before entering deep sleep.
+ *
+ * @return ESP_OK on success, ESP_FAIL if the buffer could not be locked
+ */
+esp_err_t remote_logging_retain(void);
+
 /**
  * @brief Deinitialize remote logging and free resources
  *
@@ -1,11 +1,13 @@
 #include "remote_logging.h"
 #include "hardware_config.h"
-#include "rtc_helper.h"
-#include "timezone_helper.h"
+#include "clock_service.h"
+#include "power_profile.h"
+#include "esp_attr.h"
 #include "esp_log.h"
 #include "esp_http_client.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
@@ -37,6 +39,7 @@ typedef struct {
     int count;              // Current number of entries
     int write_index;        // Next position to write
     int dropped;            // Number of dropped messages since last flush
+    int errors;             // Number of buffered ERROR messages
     SemaphoreHandle_t mutex;
     bool initialized;
 } log_buffer_t;
@@ -44,6 +47,30 @@ typedef struct {
 static log_buffer_t g_log_buffer = {0};
 static vprintf_like_t g_original_vprintf = NULL;
 
+// Task currently sending logs; its own log output is not buffered
+static volatile TaskHandle_t g_flush_task = NULL;
+
+#if HW_LOG_RETAINED_SIZE > HW_LOG_BUFFER_SIZE
+    #error "HW_LOG_RETAINED_SIZE must not exceed HW_LOG_BUFFER_SIZE"
+#endif
+
+// RTC memory keeps unsent messages across deep sleep when a wake skips WiFi
+RTC_DATA_ATTR static log_entry_t s_retained_entries[HW_LOG_RETAINED_SIZE];
+RTC_DATA_ATTR static int s_retained_count = 0;
+RTC_DATA_ATTR static int s_retained_dropped = 0;
+
+_Static_assert(sizeof(s_retained_entries) + sizeof(s_retained_count) + sizeof(s_retained_dropped) <=
+               HW_RTC_BUDGET_LOG_RETAINED, "HW_LOG_RETAINED_SIZE exceeds HW_RTC_BUDGET_LOG_RETAINED");
+
+static bool is_error_entry(const log_entry_t *entry) {
+    return strcmp(entry->level, "ERROR") == 0;
+}
+
+// Index of the oldest message in the circular buffer (caller holds mutex)
+static int oldest_index(void) {
+    return (g_log_buffer.write_index - g_log_buffer.count + g_log_buffer.capacity) % g_log_buffer.capacity;
+}
+
 // Parse log level from formatted log string
 static void parse_log_entry(const char *log_str, char *level, char *tag, char *message) {
     // ESP-IDF log format: "X (12345) TAG: message"
@@ -91,31 +118,6 @@ static void parse_log_entry(const char *log_str, char *level, char *tag, char *m
     message[127] = '\0';
 }
 
-// Get current timestamp from RTC (in local time)
-static void get_timestamp(char *timestamp_str) {
-    datetime_t utc_time, local_time;
-
-    // Read UTC time from RTC
-    if (rtc_read_time(&utc_time) != ESP_OK) {
-        strcpy(timestamp_str, "0000-00-00 00:00:00");
-        return;
-    }
-
-    // Convert to local time (CET/CEST with automatic DST)
-    if (utc_to_local(&utc_time, &local_time) != ESP_OK) {
-        // Fallback to UTC if conversion fails
-        snprintf(timestamp_str, 20, "%04d-%02d-%02d %02d:%02d:%02d",
-                 utc_time.year, utc_time.month, utc_time.day,
-                 utc_time.hour, utc_time.minute, utc_time.second);
-        return;
-    }
-
-    // Use local time for timestamp
-    snprintf(timestamp_str, 20, "%04d-%02d-%02d %02d:%02d:%02d",
-             local_time.year, local_time.month, local_time.day,
-             local_time.hour, local_time.minute, local_time.second);
-}
-
 // Check if a tag is allowed for remote logging
 static bool is_tag_allowed(const char *tag) {
 #ifdef HW_REMOTE_LOG_TAG_COUNT
@@ -157,6 +159,12 @@ static int remote_vprintf(const char *fmt, va_list args) {
         return ret;
     }
 
+    // Don't buffer messages produced while flushing (HTTP client, flush status);
+    // other tasks keep logging into the buffer during the upload
+    if (g_flush_task != NULL && g_flush_task == xTaskGetCurrentTaskHandle()) {
+        return ret;
+    }
+
     // Format the log message
     char log_buffer[256];
     vsnprintf(log_buffer, sizeof(log_buffer), fmt, args);
@@ -176,14 +184,21 @@ static int remote_vprintf(const char *fmt, va_list args) {
         return ret; // Tag not in whitelist, skip buffering
     }
 
+    // Timestamp from the clock service (no I2C), taken before locking the buffer
+    char timestamp[20];
+    clock_format_local(timestamp, sizeof(timestamp));
+
     // Add to circular buffer (thread-safe)
     if (xSemaphoreTake(g_log_buffer.mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
         log_entry_t *entry = &g_log_buffer.entries[g_log_buffer.write_index];
 
-        // Get timestamp
-        get_timestamp(entry->timestamp);
+        // Overwriting the oldest message when full
+        if (g_log_buffer.count == g_log_buffer.capacity && is_error_entry(entry)) {
+            g_log_buffer.errors--;
+        }
 
         // Copy parsed data
+        memcpy(entry->timestamp, timestamp, sizeof(entry->timestamp));
         strncpy(entry->level, level, sizeof(entry->level) - 1);
         entry->level[sizeof(entry->level) - 1] = '\0';
 
@@ -193,6 +208,10 @@ static int remote_vprintf(const char *fmt, va_list args) {
         strncpy(entry->message, message, sizeof(entry->message) - 1);
         entry->message[sizeof(entry->message) - 1] = '\0';
 
+        if (is_error_entry(entry)) {
+            g_log_buffer.errors++;
+        }
+
         // Move write index (circular)
         g_log_buffer.write_index = (g_log_buffer.write_index + 1) % g_log_buffer.capacity;
 
@@ -247,6 +266,22 @@ esp_err_t remote_logging_init(void) {
     g_log_buffer.count = 0;
     g_log_buffer.write_index = 0;
     g_log_buffer.dropped = 0;
+    g_log_buffer.errors = 0;
+
+    // Restore messages retained in RTC memory by previous wakes
+    int restored = (s_retained_count < HW_LOG_RETAINED_SIZE) ? s_retained_count : HW_LOG_RETAINED_SIZE;
+    for (int i = 0; i < restored; i++) {
+        g_log_buffer.entries[i] = s_retained_entries[i];
+        if (is_error_entry(&g_log_buffer.entries[i])) {
+            g_log_buffer.errors++;
+        }
+    }
+    g_log_buffer.count = restored;
+    g_log_buffer.write_index = restored % g_log_buffer.capacity;
+    g_log_buffer.dropped = s_retained_dropped;
+    s_retained_count = 0;
+    s_retained_dropped = 0;
+
     g_log_buffer.initialized = true;
 
     // Hook into logging system
@@ -254,10 +289,39 @@ esp_err_t remote_logging_init(void) {
 
     ESP_LOGI(TAG, "Remote logging initialized (buffer size: %d messages, device: %s)",
              g_log_buffer.capacity, HW_LOG_DEVICE_NAME);
+    if (restored > 0 || g_log_buffer.dropped > 0) {
+        ESP_LOGI(TAG, "Restored %d messages from RTC memory (dropped: %d)", restored, g_log_buffer.dropped);
+    }
 
     return ESP_OK;
 }
 
+// Drop the messages of a successful upload (caller holds mutex)
+// Messages overwritten during the upload were part of the snapshot, so they count as sent
+static void remove_sent_entries(int sent, int dropped_during) {
+    int remove = sent - dropped_during;
+    if (remove < 0) {
+        remove = 0;
+    }
+    if (remove > g_log_buffer.count) {
+        remove = g_log_buffer.count;
+    }
+    g_log_buffer.count -= remove;
+
+    int dropped = dropped_during - sent;
+    g_log_buffer.dropped = (dropped > 0) ? dropped : 0;
+
+    // Recount ERROR messages among the ones left
+    g_log_buffer.errors = 0;
+    int read_index = oldest_index();
+    for (int i = 0; i < g_log_buffer.count; i++) {
+        if (is_error_entry(&g_log_buffer.entries[read_index])) {
+            g_log_buffer.errors++;
+        }
+        read_index = (read_index + 1) % g_log_buffer.capacity;
+    }
+}
+
 esp_err_t remote_logging_flush(void) {
     if (!g_log_buffer.initialized) {
         return ESP_FAIL;
@@ -269,52 +333,46 @@ esp_err_t remote_logging_flush(void) {
     return ESP_OK;
 #endif
 
-    // Temporarily unhook logging to prevent recursive calls to remote_vprintf
-    // while we're inside this function (which could cause deadlock on mutex)
-    vprintf_like_t saved_vprintf = esp_log_set_vprintf(g_original_vprintf);
-
 #ifndef REMOTE_LOG_SERVER_URL
     ESP_LOGW(TAG, "REMOTE_LOG_SERVER_URL not defined in config.h, skipping flush");
-    esp_log_set_vprintf(saved_vprintf);
     return ESP_FAIL;
 #endif
 
+    // Build JSON payload
+    char *json_payload = malloc(8192); // Adjust size as needed
+    if (!json_payload) {
+        ESP_LOGE(TAG, "Failed to allocate JSON buffer");
+        return ESP_FAIL;
+    }
+
+    // Snapshot the buffer into the payload under the mutex; the upload itself runs
+    // without it so other tasks can keep logging
     if (xSemaphoreTake(g_log_buffer.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
         ESP_LOGW(TAG, "Failed to acquire mutex for flush");
-        esp_log_set_vprintf(saved_vprintf);
+        free(json_payload);
         return ESP_FAIL;
     }
 
     if (g_log_buffer.count == 0 && g_log_buffer.dropped == 0) {
         xSemaphoreGive(g_log_buffer.mutex);
-        esp_log_set_vprintf(saved_vprintf);
+        free(json_payload);
         return ESP_OK; // Nothing to send
     }
 
-    // Build JSON payload
-    char *json_payload = malloc(8192); // Adjust size as needed
-    if (!json_payload) {
-        ESP_LOGE(TAG, "Failed to allocate JSON buffer");
-        xSemaphoreGive(g_log_buffer.mutex);
-        esp_log_set_vprintf(saved_vprintf);
-        return ESP_FAIL;
-    }
-
+    // JSON building and escaping run at max CPU frequency, the upload does not
+    power_profile_compute_begin();
+    int dropped_sent = g_log_buffer.dropped;
     int offset = 0;
     offset += snprintf(json_payload + offset, 8192 - offset,
                       "{\"device\":\"%s\",\"dropped\":%d,\"logs\":[",
-                      HW_LOG_DEVICE_NAME, g_log_buffer.dropped);
+                      HW_LOG_DEVICE_NAME, dropped_sent);
 
     // Calculate read index (oldest message in circular buffer)
-    int read_index;
-    if (g_log_buffer.count < g_log_buffer.capacity) {
-        read_index = 0; // Buffer not full yet, start from beginning
-    } else {
-        read_index = g_log_buffer.write_index; // Buffer full, oldest is at write position
-    }
+    int read_index = oldest_index();
 
     // Add log entries
-    for (int i = 0; i < g_log_buffer.count && offset < 8000; i++) {
+    int sent = 0;
+    for (; sent < g_log_buffer.count && offset < 8000; sent++) {
         log_entry_t *entry = &g_log_buffer.entries[read_index];
 
         // Escape quotes in message
@@ -330,14 +388,18 @@ esp_err_t remote_logging_flush(void) {
 
         offset += snprintf(json_payload + offset, 8192 - offset,
                           "%s{\"timestamp\":\"%s\",\"level\":\"%s\",\"tag\":\"%s\",\"message\":\"%s\"}",
-                          i > 0 ? "," : "", entry->timestamp, entry->level, entry->tag, escaped_msg);
+                          sent > 0 ? "," : "", entry->timestamp, entry->level, entry->tag, escaped_msg);
 
         read_index = (read_index + 1) % g_log_buffer.capacity;
     }
 
+    xSemaphoreGive(g_log_buffer.mutex);
+
     offset += snprintf(json_payload + offset, 8192 - offset, "]}");
+    power_profile_compute_end();
 
     // Send HTTP POST
+    g_flush_task = xTaskGetCurrentTaskHandle();
     esp_http_client_config_t config = {
         .url = REMOTE_LOG_SERVER_URL,
         .method = HTTP_METHOD_POST,
@@ -348,8 +410,7 @@ esp_err_t remote_logging_flush(void) {
     if (!client) {
         ESP_LOGE(TAG, "Failed to initialize HTTP client");
         free(json_payload);
-        xSemaphoreGive(g_log_buffer.mutex);
-        esp_log_set_vprintf(saved_vprintf);
+        g_flush_task = NULL;
         return ESP_FAIL;
     }
 
@@ -362,23 +423,24 @@ esp_err_t remote_logging_flush(void) {
     esp_http_client_cleanup(client);
     free(json_payload);
 
-    if (err == ESP_OK && status_code >= 200 && status_code < 300) {
-        ESP_LOGI(TAG, "Flushed %d logs to server (dropped: %d)", g_log_buffer.count, g_log_buffer.dropped);
+    if (err != ESP_OK || status_code < 200 || status_code >= 300) {
+        ESP_LOGW(TAG, "Failed to send logs: HTTP %d, err=%d", status_code, err);
+        g_flush_task = NULL;
+        return ESP_FAIL;
+    }
 
-        // Clear buffer after successful send
-        g_log_buffer.count = 0;
-        g_log_buffer.write_index = 0;
-        g_log_buffer.dropped = 0;
+    ESP_LOGI(TAG, "Flushed %d logs to server (dropped: %d)", sent, dropped_sent);
+    g_flush_task = NULL;
 
-        xSemaphoreGive(g_log_buffer.mutex);
-        esp_log_set_vprintf(saved_vprintf);
+    // Remove what was sent; messages logged during the upload stay buffered
+    if (xSemaphoreTake(g_log_buffer.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to acquire mutex after flush, logs may be sent twice");
         return ESP_OK;
-    } else {
-        ESP_LOGW(TAG, "Failed to send logs: HTTP %d, err=%d", status_code, err);
-        xSemaphoreGive(g_log_buffer.mutex);
-        esp_log_set_vprintf(saved_vprintf);
-        return ESP_FAIL;
     }
+    remove_sent_entries(sent, g_log_buffer.dropped - dropped_sent);
+    xSemaphoreGive(g_log_buffer.mutex);
+
+    return ESP_OK;
 }
 
 int remote_logging_get_buffered_count(void) {
@@ -407,6 +469,44 @@ int remote_logging_get_dropped_count(void) {
     return dropped;
 }
 
+bool remote_logging_has_errors(void) {
+    if (!g_log_buffer.initialized || !g_log_buffer.mutex) {
+        return false;
+    }
+
+    bool has_errors = false;
+    if (xSemaphoreTake(g_log_buffer.mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        has_errors = g_log_buffer.errors > 0;
+        xSemaphoreGive(g_log_buffer.mutex);
+    }
+    return has_errors;
+}
+
+esp_err_t remote_logging_retain(void) {
+    if (!g_log_buffer.initialized || !g_log_buffer.mutex) {
+        return ESP_OK;
+    }
+
+    if (xSemaphoreTake(g_log_buffer.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_FAIL;
+    }
+
+    // Keep the newest messages; older ones are counted as dropped
+    int keep = (g_log_buffer.count < HW_LOG_RETAINED_SIZE) ? g_log_buffer.count : HW_LOG_RETAINED_SIZE;
+    int skipped = g_log_buffer.count - keep;
+    int read_index = (oldest_index() + skipped) % g_log_buffer.capacity;
+
+    for (int i = 0; i < keep; i++) {
+        s_retained_entries[i] = g_log_buffer.entries[read_index];
+        read_index = (read_index + 1) % g_log_buffer.capacity;
+    }
+    s_retained_count = keep;
+    s_retained_dropped = g_log_buffer.dropped + skipped;
+
+    xSemaphoreGive(g_log_buffer.mutex);
+    return ESP_OK;
+}
+
 esp_err_t remote_logging_deinit(void) {
     if (!g_log_buffer.initialized) {
         return ESP_OK;
@@ -0,0 +1,104 @@
+#include "clock_service.h"
+#include "timezone_helper.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "CLOCK";
+
+// UTC epoch read from the DS3231 and esp_timer value at that read
+static time_t s_anchor_epoch = 0;
+static int64_t s_anchor_timer_us = 0;
+static bool s_valid = false;
+
+esp_err_t clock_service_init(void) {
+    datetime_t utc_time;
+    time_t epoch;
+
+    esp_err_t ret = rtc_read_time(&utc_time);
+    int64_t timer_us = esp_timer_get_time();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = datetime_to_epoch(&utc_time, &epoch);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    s_anchor_epoch = epoch;
+    s_anchor_timer_us = timer_us;
+    s_valid = true;
+
+    ESP_LOGI(TAG, "Clock anchored to RTC: %04d-%02d-%02d %02d:%02d:%02d UTC",
+             utc_time.year, utc_time.month, utc_time.day,
+             utc_time.hour, utc_time.minute, utc_time.second);
+    return ESP_OK;
+}
+
+bool clock_service_is_valid(void) {
+    return s_valid;
+}
+
+int64_t clock_now_utc_us(void) {
+    if (!s_valid) {
+        return 0;
+    }
+    return (int64_t)s_anchor_epoch * 1000000LL + (esp_timer_get_time() - s_anchor_timer_us);
+}
+
+time_t clock_now_epoch(void) {
+    return (time_t)(clock_now_utc_us() / 1000000LL);
+}
+
+esp_err_t clock_now_utc(datetime_t *utc_dt) {
+    if (!utc_dt) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_valid) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return epoch_to_datetime(clock_now_epoch(), utc_dt);
+}
+
+esp_err_t clock_now_local(datetime_t *local_dt) {
+    if (!local_dt) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_valid) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // localtime_r() applies the TZ set by timezone_init() directly to the epoch
+    time_t epoch = clock_now_epoch();
+    struct tm local_tm;
+    if (localtime_r(&epoch, &local_tm) == NULL) {
+        return ESP_FAIL;
+    }
+
+    local_dt->year = local_tm.tm_year + 1900;
+    local_dt->month = local_tm.tm_mon + 1;
+    local_dt->day = local_tm.tm_mday;
+    local_dt->hour = local_tm.tm_hour;
+    local_dt->minute = local_tm.tm_min;
+    local_dt->second = local_tm.tm_sec;
+
+    return ESP_OK;
+}
+
+void clock_format_local(char *buf, size_t size) {
+    if (!buf || size == 0) {
+        return;
+    }
+
+    datetime_t local_time;
+    if (clock_now_local(&local_time) != ESP_OK) {
+        snprintf(buf, size, "0000-00-00 00:00:00");
+        return;
+    }
+
+    snprintf(buf, size, "%04d-%02d-%02d %02d:%02d:%02d",
+             local_time.year, local_time.month, local_time.day,
+             local_time.hour, local_time.minute, local_time.second);
+}
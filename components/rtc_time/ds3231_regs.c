@@ -0,0 +1,81 @@
+#include "ds3231_regs.h"
+
+uint8_t bcd_to_dec(uint8_t bcd) {
+    return ((bcd >> 4) * 10) + (bcd & 0x0F);
+}
+
+uint8_t dec_to_bcd(uint8_t dec) {
+    return ((dec / 10) << 4) | (dec % 10);
+}
+
+static int read_register(const ds3231_bus_t *bus, uint8_t reg, uint8_t *value) {
+    return bus->read(bus->ctx, reg, value, 1);
+}
+
+static int write_register(const ds3231_bus_t *bus, uint8_t reg, uint8_t value) {
+    return bus->write(bus->ctx, reg, &value, 1);
+}
+
+// Read-modify-write of the control register; no write if nothing changes
+static int update_control(const ds3231_bus_t *bus, uint8_t set, uint8_t clear) {
+    uint8_t control_reg;
+    int ret = read_register(bus, DS3231_REG_CONTROL, &control_reg);
+    if (ret != 0) {
+        return ret;
+    }
+
+    uint8_t new_control = (uint8_t)((control_reg | set) & ~clear);
+    return (new_control != control_reg) ? write_register(bus, DS3231_REG_CONTROL, new_control) : 0;
+}
+
+void ds3231_encode_alarm1(int day, int hour, int minute, int second, uint8_t regs[4]) {
+    // A1M1-A1M4 = 0 and DY/DT = 0: alarm when date, hours, minutes and seconds match
+    regs[0] = dec_to_bcd((uint8_t)second) & 0x7F;
+    regs[1] = dec_to_bcd((uint8_t)minute) & 0x7F;
+    regs[2] = dec_to_bcd((uint8_t)hour) & 0x3F;  // 24-hour mode
+    regs[3] = dec_to_bcd((uint8_t)day) & 0x3F;
+}
+
+int ds3231_set_alarm1(const ds3231_bus_t *bus, int day, int hour, int minute, int second) {
+    uint8_t regs[4];
+    ds3231_encode_alarm1(day, hour, minute, second, regs);
+
+    int ret = bus->write(bus->ctx, DS3231_REG_ALARM1, regs, sizeof(regs));
+    if (ret != 0) {
+        return ret;
+    }
+
+    // Clear a stale flag first, otherwise INT/SQW is already asserted
+    ret = ds3231_clear_alarm1_flag(bus, NULL);
+    if (ret != 0) {
+        return ret;
+    }
+
+    return update_control(bus, DS3231_CONTROL_INTCN | DS3231_CONTROL_A1IE, 0);
+}
+
+int ds3231_clear_alarm1_flag(const ds3231_bus_t *bus, bool *was_set) {
+    uint8_t status_reg;
+    int ret = read_register(bus, DS3231_REG_STATUS, &status_reg);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (was_set) {
+        *was_set = (status_reg & DS3231_STATUS_A1F) != 0;
+    }
+    if (!(status_reg & DS3231_STATUS_A1F)) {
+        return 0;
+    }
+
+    // Flags are cleared by writing 0; writing 1 leaves them unchanged
+    return write_register(bus, DS3231_REG_STATUS, status_reg & ~DS3231_STATUS_A1F);
+}
+
+int ds3231_disable_alarm1(const ds3231_bus_t *bus) {
+    int ret = update_control(bus, 0, DS3231_CONTROL_A1IE);
+    if (ret != 0) {
+        return ret;
+    }
+    return ds3231_clear_alarm1_flag(bus, NULL);
+}
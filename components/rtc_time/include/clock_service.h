@@ -0,0 +1,71 @@
+#ifndef CLOCK_SERVICE_H
+#define CLOCK_SERVICE_H
+
+#include "esp_err.h"
+#include "rtc_helper.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Read the DS3231 once and anchor it to esp_timer_get_time()
+ *
+ * All later time queries are served from this anchor without I2C traffic.
+ * The DS3231 has one-second resolution, so the anchor may lag real time by
+ * up to one second; esp_timer provides the sub-second progression.
+ * Requires rtc_i2c_init() and, for local time, timezone_init().
+ *
+ * @return ESP_OK on success, error code from the RTC read otherwise
+ */
+esp_err_t clock_service_init(void);
+
+/**
+ * @brief Check whether the clock has been anchored to the RTC
+ *
+ * @return true after a successful clock_service_init()
+ */
+bool clock_service_is_valid(void);
+
+/**
+ * @brief Get current UTC time in microseconds since the Unix epoch
+ *
+ * @return UTC microseconds, or 0 if not anchored
+ */
+int64_t clock_now_utc_us(void);
+
+/**
+ * @brief Get current UTC time in seconds since the Unix epoch
+ *
+ * @return UTC seconds, or 0 if not anchored
+ */
+time_t clock_now_epoch(void);
+
+/**
+ * @brief Get current UTC date and time
+ *
+ * @param utc_dt Pointer to datetime_t structure to store UTC time
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not anchored
+ */
+esp_err_t clock_now_utc(datetime_t *utc_dt);
+
+/**
+ * @brief Get current local date and time (configured timezone with DST)
+ *
+ * @param local_dt Pointer to datetime_t structure to store local time
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not anchored
+ */
+esp_err_t clock_now_local(datetime_t *local_dt);
+
+/**
+ * @brief Format current local time as "YYYY-MM-DD HH:MM:SS"
+ *
+ * Safe to call from the log hook: no I2C access and no logging.
+ * Writes "0000-00-00 00:00:00" if not anchored.
+ *
+ * @param buf Output buffer (at least 20 bytes)
+ * @param size Size of output buffer
+ */
+void clock_format_local(char *buf, size_t size);
+
+#endif // CLOCK_SERVICE_H
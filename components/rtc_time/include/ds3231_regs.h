@@ -0,0 +1,115 @@
+#ifndef DS3231_REGS_H
+#define DS3231_REGS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file ds3231_regs.h
+ * @brief DS3231 register map and Alarm 1 register logic
+ *
+ * The Alarm 1 sequences (program the match registers, clear A1F, set or clear
+ * A1IE) are written against a small register read/write interface instead of
+ * the I2C driver. rtc_helper.c binds it to the I2C bus; on the host it can be
+ * bound to a fake register file (see tools/ds3231_check).
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+// I2C address of the DS3231
+#define DS3231_ADDR 0x68
+
+// DS3231 Register addresses
+#define DS3231_REG_TIME     0x00  // Time registers start
+#define DS3231_REG_ALARM1   0x07  // Alarm 1 registers start (seconds, minutes, hours, day/date)
+#define DS3231_REG_CONTROL  0x0E  // Control register
+#define DS3231_REG_STATUS   0x0F  // Status register
+
+// DS3231 Control register bits
+#define DS3231_CONTROL_EOSC   (1 << 7)  // Enable Oscillator (0 = enabled, 1 = disabled)
+#define DS3231_CONTROL_BBSQW  (1 << 6)  // Battery-Backed Square Wave
+#define DS3231_CONTROL_CONV   (1 << 5)  // Convert Temperature
+#define DS3231_CONTROL_INTCN  (1 << 2)  // Interrupt Control
+#define DS3231_CONTROL_A2IE   (1 << 1)  // Alarm 2 Interrupt Enable
+#define DS3231_CONTROL_A1IE   (1 << 0)  // Alarm 1 Interrupt Enable
+
+// DS3231 Status register bits
+#define DS3231_STATUS_OSF     (1 << 7)  // Oscillator Stop Flag
+#define DS3231_STATUS_A2F     (1 << 1)  // Alarm 2 Flag
+#define DS3231_STATUS_A1F     (1 << 0)  // Alarm 1 Flag
+
+// DS3231 Alarm register bits
+#define DS3231_ALARM_MASK     (1 << 7)  // A1Mx: ignore this field when matching
+#define DS3231_ALARM_DY_DT    (1 << 6)  // Day/date register holds day of week (1) or date (0)
+
+/**
+ * @brief Register access used by the Alarm 1 functions
+ *
+ * Both callbacks return 0 on success or an error code, which is passed on to
+ * the caller unchanged (esp_err_t values on the device).
+ */
+typedef struct {
+    int (*read)(void *ctx, uint8_t reg, uint8_t *data, size_t len);
+    int (*write)(void *ctx, uint8_t reg, const uint8_t *data, size_t len);
+    void *ctx;
+} ds3231_bus_t;
+
+/**
+ * @brief Encode Alarm 1 registers (0x07-0x0A) to match date, hour, minute and second
+ *
+ * @param day Day of month 1-31
+ * @param hour Hour 0-23 (24-hour mode)
+ * @param minute Minute 0-59
+ * @param second Second 0-59
+ * @param regs Output: 4 register values for DS3231_REG_ALARM1..0x0A
+ */
+void ds3231_encode_alarm1(int day, int hour, int minute, int second, uint8_t regs[4]);
+
+/**
+ * @brief Program Alarm 1 and enable its interrupt on INT/SQW
+ *
+ * Writes the match registers, clears a pending A1F (otherwise INT/SQW is
+ * asserted at once) and sets INTCN and A1IE, leaving the other control bits
+ * as they are. Arguments must be in range (see ds3231_encode_alarm1()).
+ *
+ * @return 0 on success, bus error code otherwise
+ */
+int ds3231_set_alarm1(const ds3231_bus_t *bus, int day, int hour, int minute, int second);
+
+/**
+ * @brief Clear the Alarm 1 flag (A1F), releasing INT/SQW
+ *
+ * Only writes the status register when the flag is set. A2F and OSF are
+ * left as they are.
+ *
+ * @param bus Register access
+ * @param was_set Optional: set to whether A1F was set (may be NULL)
+ * @return 0 on success, bus error code otherwise
+ */
+int ds3231_clear_alarm1_flag(const ds3231_bus_t *bus, bool *was_set);
+
+/**
+ * @brief Disable the Alarm 1 interrupt (A1IE=0) and clear a pending A1F
+ *
+ * @return 0 on success, bus error code otherwise
+ */
+int ds3231_disable_alarm1(const ds3231_bus_t *bus);
+
+/**
+ * @brief Convert BCD (Binary Coded Decimal) to decimal
+ *
+ * @param bcd BCD value
+ * @return Decimal value
+ */
+uint8_t bcd_to_dec(uint8_t bcd);
+
+/**
+ * @brief Convert decimal to BCD (Binary Coded Decimal)
+ *
+ * @param dec Decimal value
+ * @return BCD value
+ */
+uint8_t dec_to_bcd(uint8_t dec);
+
+#endif // DS3231_REGS_H
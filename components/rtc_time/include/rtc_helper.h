@@ -2,25 +2,10 @@
 #define RTC_HELPER_H
 
 #include "esp_err.h"
+#include "ds3231_regs.h"
+#include <stdbool.h>
 #include <stdint.h>
 
-// I2C configuration for DS3231 RTC
-#define DS3231_ADDR 0x68
-
-// DS3231 Register addresses
-#define DS3231_REG_TIME     0x00  // Time registers start
-#define DS3231_REG_CONTROL  0x0E  // Control register
-#define DS3231_REG_STATUS   0x0F  // Status register
-
-// DS3231 Control register bits
-#define DS3231_CONTROL_EOSC   (1 << 7)  // Enable Oscillator (0 = enabled, 1 = disabled)
-#define DS3231_CONTROL_BBSQW  (1 << 6)  // Battery-Backed Square Wave
-#define DS3231_CONTROL_CONV   (1 << 5)  // Convert Temperature
-#define DS3231_CONTROL_INTCN  (1 << 2)  // Interrupt Control
-
-// DS3231 Status register bits
-#define DS3231_STATUS_OSF     (1 << 7)  // Oscillator Stop Flag
-
 // Date/time structure
 typedef struct {
     int year;
@@ -73,19 +58,31 @@ esp_err_t rtc_read_time(datetime_t *dt);
 esp_err_t rtc_write_time(const datetime_t *dt);
 
 /**
- * @brief Convert BCD (Binary Coded Decimal) to decimal
+ * @brief Set DS3231 Alarm 1 to fire at the given UTC date and time
+ *
+ * Programs the alarm to match date, hour, minute and second, clears any pending
+ * Alarm 1 flag and enables the Alarm 1 interrupt on the INT/SQW pin (INTCN=1,
+ * A1IE=1). The INT/SQW pin is open-drain and goes low when the alarm fires,
+ * until rtc_clear_alarm1_flag() is called.
+ *
+ * @param dt Pointer to datetime_t structure containing the alarm time (UTC)
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t rtc_set_alarm1(const datetime_t *dt);
+
+/**
+ * @brief Clear the DS3231 Alarm 1 flag (A1F), releasing the INT/SQW pin
  *
- * @param bcd BCD value
- * @return Decimal value
+ * @param was_set Optional pointer to store whether the flag was set (may be NULL)
+ * @return ESP_OK on success, error code otherwise
  */
-uint8_t bcd_to_dec(uint8_t bcd);
+esp_err_t rtc_clear_alarm1_flag(bool *was_set);
 
 /**
- * @brief Convert decimal to BCD (Binary Coded Decimal)
+ * @brief Disable the DS3231 Alarm 1 interrupt (A1IE=0) and release INT/SQW
  *
- * @param dec Decimal value
- * @return BCD value
+ * @return ESP_OK on success, error code otherwise
  */
-uint8_t dec_to_bcd(uint8_t dec);
+esp_err_t rtc_disable_alarm1(void);
 
 #endif // RTC_HELPER_H
@@ -55,4 +55,22 @@ esp_err_t get_timezone_offset(const datetime_t *utc_dt, int *offset_seconds);
  */
 esp_err_t get_timezone_abbr(const datetime_t *utc_dt, char *tz_abbr);
 
+/**
+ * @brief Convert UTC datetime to seconds since the Unix epoch
+ *
+ * @param utc_dt Pointer to datetime_t structure containing UTC time
+ * @param epoch Pointer to store seconds since 1970-01-01 00:00:00 UTC
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t datetime_to_epoch(const datetime_t *utc_dt, time_t *epoch);
+
+/**
+ * @brief Convert seconds since the Unix epoch to UTC datetime
+ *
+ * @param epoch Seconds since 1970-01-01 00:00:00 UTC
+ * @param utc_dt Pointer to datetime_t structure to store UTC time
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t epoch_to_datetime(time_t epoch, datetime_t *utc_dt);
+
 #endif // TIMEZONE_HELPER_H
@@ -8,16 +8,6 @@ static const char *TAG = "RTC_HELPER";
 #define I2C_MASTER_NUM I2C_NUM_0
 #define I2C_MASTER_FREQ_HZ 100000
 
-// Convert BCD to decimal
-uint8_t bcd_to_dec(uint8_t bcd) {
-    return ((bcd >> 4) * 10) + (bcd & 0x0F);
-}
-
-// Convert decimal to BCD
-uint8_t dec_to_bcd(uint8_t dec) {
-    return ((dec / 10) << 4) | (dec % 10);
-}
-
 esp_err_t rtc_i2c_init(int sda_pin, int scl_pin) {
     i2c_config_t conf = {
         .mode = I2C_MODE_MASTER,
@@ -204,3 +194,65 @@ esp_err_t rtc_write_time(const datetime_t *dt) {
 
     return ESP_OK;
 }
+
+static int i2c_bus_read(void *ctx, uint8_t reg, uint8_t *data, size_t len) {
+    (void)ctx;
+    return i2c_master_write_read_device(I2C_MASTER_NUM, DS3231_ADDR, &reg, 1, data, len,
+                                        1000 / portTICK_PERIOD_MS);
+}
+
+static int i2c_bus_write(void *ctx, uint8_t reg, const uint8_t *data, size_t len) {
+    (void)ctx;
+    uint8_t buf[8];
+    if (len + 1 > sizeof(buf)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    buf[0] = reg;
+    memcpy(&buf[1], data, len);
+    return i2c_master_write_to_device(I2C_MASTER_NUM, DS3231_ADDR, buf, len + 1,
+                                      1000 / portTICK_PERIOD_MS);
+}
+
+// Alarm register logic (ds3231_regs.c) runs on the I2C bus
+static const ds3231_bus_t s_bus = {
+    .read = i2c_bus_read,
+    .write = i2c_bus_write,
+    .ctx = NULL,
+};
+
+esp_err_t rtc_set_alarm1(const datetime_t *dt) {
+    if (!dt) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dt->day < 1 || dt->day > 31 || dt->hour > 23 || dt->minute > 59 || dt->second > 59) {
+        ESP_LOGE(TAG, "Invalid alarm time");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ds3231_set_alarm1(&s_bus, dt->day, dt->hour, dt->minute, dt->second);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set alarm 1: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Alarm 1 set to (UTC): day %02d %02d:%02d:%02d",
+             dt->day, dt->hour, dt->minute, dt->second);
+    return ESP_OK;
+}
+
+esp_err_t rtc_clear_alarm1_flag(bool *was_set) {
+    esp_err_t ret = ds3231_clear_alarm1_flag(&s_bus, was_set);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to clear A1F flag: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+esp_err_t rtc_disable_alarm1(void) {
+    esp_err_t ret = ds3231_disable_alarm1(&s_bus);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to disable alarm 1: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
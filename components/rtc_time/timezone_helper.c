@@ -205,3 +205,47 @@ esp_err_t get_timezone_abbr(const datetime_t *utc_dt, char *tz_abbr) {
 
     return ESP_OK;
 }
+
+esp_err_t datetime_to_epoch(const datetime_t *utc_dt, time_t *epoch) {
+    if (!utc_dt || !epoch) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct tm utc_tm = {0};
+    utc_tm.tm_year = utc_dt->year - 1900;
+    utc_tm.tm_mon = utc_dt->month - 1;
+    utc_tm.tm_mday = utc_dt->day;
+    utc_tm.tm_hour = utc_dt->hour;
+    utc_tm.tm_min = utc_dt->minute;
+    utc_tm.tm_sec = utc_dt->second;
+    utc_tm.tm_isdst = 0;
+
+    time_t utc_time = portable_timegm(&utc_tm);
+    if (utc_time == (time_t)-1) {
+        ESP_LOGE(TAG, "Failed to convert UTC time to epoch");
+        return ESP_FAIL;
+    }
+
+    *epoch = utc_time;
+    return ESP_OK;
+}
+
+esp_err_t epoch_to_datetime(time_t epoch, datetime_t *utc_dt) {
+    if (!utc_dt) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct tm utc_tm;
+    if (gmtime_r(&epoch, &utc_tm) == NULL) {
+        return ESP_FAIL;
+    }
+
+    utc_dt->year = utc_tm.tm_year + 1900;
+    utc_dt->month = utc_tm.tm_mon + 1;
+    utc_dt->day = utc_tm.tm_mday;
+    utc_dt->hour = utc_tm.tm_hour;
+    utc_dt->minute = utc_tm.tm_min;
+    utc_dt->second = utc_tm.tm_sec;
+
+    return ESP_OK;
+}
@@ -0,0 +1,54 @@
+#ifndef NETWORK_POLICY_H
+#define NETWORK_POLICY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file network_policy.h
+ * @brief Decide whether a wake needs to bring WiFi up
+ *
+ * WiFi association and DHCP are the most expensive part of a wake, so the
+ * radio is only started when there is something to fetch or send.
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+// Reasons for bringing WiFi up (bitmask)
+#define NETWORK_REASON_NONE            0
+#define NETWORK_REASON_WEATHER_FETCH   (1 << 0)  // Weather forecast fetch is due
+#define NETWORK_REASON_LOG_HIGH_WATER  (1 << 1)  // Log buffer passed the high-water mark
+#define NETWORK_REASON_LOG_ERROR       (1 << 2)  // An ERROR message is buffered
+#define NETWORK_REASON_STALE           (1 << 3)  // Too long since the last upload
+
+// Inputs for the network decision
+typedef struct {
+    bool weather_fetch_due;          // Weather forecast fetch is due on this wake
+    int buffered_logs;               // Messages currently in the log buffer
+    int log_high_water;              // Flush when buffered_logs reaches this (<= 0 = disabled)
+    bool has_error_logs;             // An ERROR message is buffered
+    long seconds_since_upload;       // Seconds since last successful upload (< 0 = never)
+    long max_staleness_seconds;      // Upload at least this often (<= 0 = disabled)
+    bool upload_wake;                // Wake was scheduled for the log upload deadline
+} network_policy_input_t;
+
+/**
+ * @brief Evaluate which reasons call for WiFi on this wake
+ *
+ * @param input Decision inputs
+ * @return Bitmask of NETWORK_REASON_* values (NETWORK_REASON_NONE = skip WiFi)
+ */
+uint32_t network_policy_evaluate(const network_policy_input_t *input);
+
+/**
+ * @brief Format a NETWORK_REASON_* bitmask for logging (e.g., "weather_fetch+log_error")
+ *
+ * @param reasons Bitmask of NETWORK_REASON_* values
+ * @param buf Output buffer
+ * @param size Size of output buffer in bytes
+ * @return buf
+ */
+const char *network_policy_describe(uint32_t reasons, char *buf, size_t size);
+
+#endif // NETWORK_POLICY_H
@@ -0,0 +1,54 @@
+#ifndef SLEEP_DRIFT_H
+#define SLEEP_DRIFT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file sleep_drift.h
+ * @brief Learned compensation for deep sleep timer drift
+ *
+ * The deep sleep timer runs from the internal RTC oscillator, which drifts by
+ * up to a few percent. Each timer wake compares the requested sleep duration
+ * with the elapsed time measured by the DS3231 and folds the error into a
+ * filtered estimate (parts per million). The estimate is then used to correct
+ * the next requested duration so the device wakes close to its target time.
+ *
+ * Pure logic with no ESP-IDF dependencies; the caller keeps the state in RTC memory.
+ */
+
+// Sleeps shorter than this are ignored (DS3231 has 1 second resolution)
+#define SLEEP_DRIFT_MIN_SAMPLE_US (10LL * 60 * 1000000)
+
+// Samples with a larger error are treated as outliers (clock set, reset, ...)
+#define SLEEP_DRIFT_MAX_PPM 100000
+
+// Weight of a new sample in the filtered estimate (1/N)
+#define SLEEP_DRIFT_FILTER_DIV 4
+
+// Filtered drift estimate
+typedef struct {
+    int32_t drift_ppm;      // (actual / requested - 1) * 1e6; positive = timer wakes late
+    uint32_t samples;       // Number of accepted samples
+} sleep_drift_t;
+
+/**
+ * @brief Fold one measured sleep into the drift estimate
+ *
+ * @param drift Drift state
+ * @param requested_us Duration passed to the sleep timer
+ * @param actual_us Duration measured with the reference clock
+ * @return true if the sample was accepted, false if it was rejected
+ */
+bool sleep_drift_update(sleep_drift_t *drift, int64_t requested_us, int64_t actual_us);
+
+/**
+ * @brief Convert a wanted sleep duration into the duration to request from the timer
+ *
+ * @param drift Drift state
+ * @param target_us Wanted real sleep duration
+ * @return Duration to request so the real sleep matches target_us
+ */
+int64_t sleep_drift_correct(const sleep_drift_t *drift, int64_t target_us);
+
+#endif // SLEEP_DRIFT_H
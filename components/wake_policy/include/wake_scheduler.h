@@ -0,0 +1,89 @@
+#ifndef WAKE_SCHEDULER_H
+#define WAKE_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file wake_scheduler.h
+ * @brief Event-driven wake scheduling
+ *
+ * Works out the next local hour at which a wake actually matters (pin on,
+ * pin off, weather check, log upload deadline) so the device can sleep
+ * straight to it instead of waking every hour.
+ *
+ * Every wake it picks changes an output or uses the network, so there are no
+ * no-op wakes left to absorb in a deep sleep wake stub. Log upload deadlines
+ * are dropped while uploads are blocked (see wifi_reconnect_wake_allowed()),
+ * since such a wake would boot, skip WiFi and go back to sleep.
+ *
+ * Pure logic with no ESP-IDF dependencies: the caller supplies the current
+ * hour and schedule, which makes it easy to drive from a simulated clock.
+ */
+
+// Events that can make a wake necessary (bitmask)
+#define WAKE_EVENT_NONE          0
+#define WAKE_EVENT_PIN_ON        (1 << 0)  // Control pin turns on
+#define WAKE_EVENT_PIN_OFF       (1 << 1)  // Control pin turns off
+#define WAKE_EVENT_WEATHER_CHECK (1 << 2)  // Weather forecast fetch
+#define WAKE_EVENT_LOG_UPLOAD    (1 << 3)  // Remote log upload deadline
+
+// Schedule inputs (all hours in local time, 24h format)
+typedef struct {
+    int pin_on_hour;             // Hour when control pin turns on
+    int pin_off_hour;            // Hour when control pin turns off
+    int weather_check_hour;      // Hour to fetch the weather forecast
+    int log_upload_due_hours;    // Hours from now until the log upload deadline (<= 0 = none)
+    bool uploads_blocked;        // WiFi is skipped for log uploads (failed connects): no upload wakes
+} wake_schedule_t;
+
+// Next wake chosen by the scheduler
+typedef struct {
+    int hours_ahead;             // Whole hours from the current hour (1-24)
+    int hour;                    // Local hour of the wake (0-23)
+    uint32_t events;             // WAKE_EVENT_* bits due at that hour
+} wake_plan_t;
+
+/**
+ * @brief Get events due at a given local hour
+ *
+ * @param schedule Schedule inputs
+ * @param hour Local hour (0-23)
+ * @param hours_ahead Distance of that hour from now (used for the log deadline)
+ * @return Bitmask of WAKE_EVENT_* values
+ */
+uint32_t wake_scheduler_events_at(const wake_schedule_t *schedule, int hour, int hours_ahead);
+
+/**
+ * @brief Whether the control pin is on at a given local hour
+ *
+ * @param schedule Schedule inputs
+ * @param hour Local hour (0-23)
+ * @return true from pin_on_hour up to (not including) pin_off_hour
+ */
+bool wake_scheduler_pin_active(const wake_schedule_t *schedule, int hour);
+
+/**
+ * @brief Find the next hour with at least one event
+ *
+ * Searches the 24 hours after current_hour. Since the pin on/off and weather
+ * check hours repeat daily, a wake is always found within 24 hours.
+ *
+ * @param schedule Schedule inputs
+ * @param current_hour Current local hour (0-23)
+ * @param plan Pointer to store the next wake
+ */
+void wake_scheduler_next(const wake_schedule_t *schedule, int current_hour, wake_plan_t *plan);
+
+/**
+ * @brief Format a WAKE_EVENT_* bitmask for logging (e.g., "pin_off+log_upload")
+ *
+ * @param events Bitmask of WAKE_EVENT_* values
+ * @param buf Output buffer
+ * @param size Size of output buffer in bytes
+ * @return buf
+ */
+const char *wake_scheduler_describe(uint32_t events, char *buf, size_t size);
+
+#endif // WAKE_SCHEDULER_H
@@ -0,0 +1,60 @@
+#include "network_policy.h"
+#include <stdio.h>
+
+uint32_t network_policy_evaluate(const network_policy_input_t *input) {
+    if (!input) {
+        return NETWORK_REASON_NONE;
+    }
+
+    uint32_t reasons = NETWORK_REASON_NONE;
+    if (input->weather_fetch_due) {
+        reasons |= NETWORK_REASON_WEATHER_FETCH;
+    }
+    if (input->log_high_water > 0 && input->buffered_logs >= input->log_high_water) {
+        reasons |= NETWORK_REASON_LOG_HIGH_WATER;
+    }
+    if (input->has_error_logs) {
+        reasons |= NETWORK_REASON_LOG_ERROR;
+    }
+    // A wake planned in local hours can come an hour early in real time (spring DST change)
+    if (input->upload_wake ||
+        (input->max_staleness_seconds > 0 &&
+         (input->seconds_since_upload < 0 || input->seconds_since_upload >= input->max_staleness_seconds))) {
+        reasons |= NETWORK_REASON_STALE;
+    }
+    return reasons;
+}
+
+const char *network_policy_describe(uint32_t reasons, char *buf, size_t size) {
+    static const struct {
+        uint32_t bit;
+        const char *name;
+    } names[] = {
+        {NETWORK_REASON_WEATHER_FETCH, "weather_fetch"},
+        {NETWORK_REASON_LOG_HIGH_WATER, "log_high_water"},
+        {NETWORK_REASON_LOG_ERROR, "log_error"},
+        {NETWORK_REASON_STALE, "stale"},
+    };
+
+    if (!buf || size == 0) {
+        return buf;
+    }
+
+    size_t offset = 0;
+    buf[0] = '\0';
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]) && offset < size; i++) {
+        if (reasons & names[i].bit) {
+            int written = snprintf(buf + offset, size - offset, "%s%s",
+                                   offset > 0 ? "+" : "", names[i].name);
+            if (written < 0) {
+                break;
+            }
+            offset += (size_t)written;
+        }
+    }
+
+    if (buf[0] == '\0') {
+        snprintf(buf, size, "none");
+    }
+    return buf;
+}
@@ -0,0 +1,27 @@
+#include "sleep_drift.h"
+
+bool sleep_drift_update(sleep_drift_t *drift, int64_t requested_us, int64_t actual_us) {
+    if (!drift || requested_us < SLEEP_DRIFT_MIN_SAMPLE_US || actual_us <= 0) {
+        return false;
+    }
+
+    int64_t sample_ppm = ((actual_us - requested_us) * 1000000LL) / requested_us;
+    if (sample_ppm > SLEEP_DRIFT_MAX_PPM || sample_ppm < -SLEEP_DRIFT_MAX_PPM) {
+        return false;
+    }
+
+    if (drift->samples == 0) {
+        drift->drift_ppm = (int32_t)sample_ppm;
+    } else {
+        drift->drift_ppm += (int32_t)((sample_ppm - drift->drift_ppm) / SLEEP_DRIFT_FILTER_DIV);
+    }
+    drift->samples++;
+    return true;
+}
+
+int64_t sleep_drift_correct(const sleep_drift_t *drift, int64_t target_us) {
+    if (!drift || drift->samples == 0 || target_us <= 0) {
+        return target_us;
+    }
+    return (target_us * 1000000LL) / (1000000LL + drift->drift_ppm);
+}
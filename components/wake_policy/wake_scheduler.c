@@ -0,0 +1,84 @@
+#include "wake_scheduler.h"
+#include <stdio.h>
+
+uint32_t wake_scheduler_events_at(const wake_schedule_t *schedule, int hour, int hours_ahead) {
+    if (!schedule) {
+        return WAKE_EVENT_NONE;
+    }
+
+    uint32_t events = WAKE_EVENT_NONE;
+    if (hour == schedule->pin_on_hour) {
+        events |= WAKE_EVENT_PIN_ON;
+    }
+    if (hour == schedule->pin_off_hour) {
+        events |= WAKE_EVENT_PIN_OFF;
+    }
+    if (hour == schedule->weather_check_hour) {
+        events |= WAKE_EVENT_WEATHER_CHECK;
+    }
+    if (!schedule->uploads_blocked && schedule->log_upload_due_hours > 0 &&
+        hours_ahead >= schedule->log_upload_due_hours) {
+        events |= WAKE_EVENT_LOG_UPLOAD;
+    }
+    return events;
+}
+
+bool wake_scheduler_pin_active(const wake_schedule_t *schedule, int hour) {
+    return schedule && hour >= schedule->pin_on_hour && hour < schedule->pin_off_hour;
+}
+
+void wake_scheduler_next(const wake_schedule_t *schedule, int current_hour, wake_plan_t *plan) {
+    if (!plan) {
+        return;
+    }
+
+    // Fallback: wake at the same hour tomorrow
+    plan->hours_ahead = 24;
+    plan->hour = current_hour;
+    plan->events = WAKE_EVENT_NONE;
+
+    for (int ahead = 1; ahead <= 24; ahead++) {
+        int hour = (current_hour + ahead) % 24;
+        uint32_t events = wake_scheduler_events_at(schedule, hour, ahead);
+        if (events != WAKE_EVENT_NONE) {
+            plan->hours_ahead = ahead;
+            plan->hour = hour;
+            plan->events = events;
+            return;
+        }
+    }
+}
+
+const char *wake_scheduler_describe(uint32_t events, char *buf, size_t size) {
+    static const struct {
+        uint32_t bit;
+        const char *name;
+    } names[] = {
+        {WAKE_EVENT_PIN_ON, "pin_on"},
+        {WAKE_EVENT_PIN_OFF, "pin_off"},
+        {WAKE_EVENT_WEATHER_CHECK, "weather_check"},
+        {WAKE_EVENT_LOG_UPLOAD, "log_upload"},
+    };
+
+    if (!buf || size == 0) {
+        return buf;
+    }
+
+    size_t offset = 0;
+    buf[0] = '\0';
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]) && offset < size; i++) {
+        if (events & names[i].bit) {
+            int written = snprintf(buf + offset, size - offset, "%s%s",
+                                   offset > 0 ? "+" : "", names[i].name);
+            if (written < 0) {
+                break;
+            }
+            offset += (size_t)written;
+        }
+    }
+
+    if (buf[0] == '\0') {
+        snprintf(buf, size, "none");
+    }
+    return buf;
+}
@@ -0,0 +1,119 @@
+#ifndef WAKE_PROFILER_H
+#define WAKE_PROFILER_H
+
+#include "hardware_config.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file wake_profiler.h
+ * @brief Per-phase timing of the wake cycle, persisted across deep sleep
+ *
+ * Each phase of app_main is bracketed with wake_profiler_begin()/wake_profiler_end().
+ * Durations are measured with esp_timer and summed per wake (a phase can run
+ * more than once); wake_profiler_finish_wake() folds each wake's total into
+ * per-phase min/avg/max statistics kept in RTC memory. The statistics accumulate over consecutive wakes
+ * until they are shipped with the weather diagnostics upload and reset.
+ *
+ * Phases that run in their own task also record the task's unused stack, so
+ * the stack sizes can be checked against measured worst cases (e.g., a full
+ * TLS handshake in the fetch task).
+ */
+
+// Wake cycle phases, in the order app_main runs them
+typedef enum {
+    WAKE_PHASE_TIMEZONE_INIT = 0,
+    WAKE_PHASE_RTC_I2C_INIT,
+    WAKE_PHASE_REMOTE_LOGGING_INIT,
+    WAKE_PHASE_RGB_LED_INIT,
+    WAKE_PHASE_WAIT_TARGET_SECOND,
+    WAKE_PHASE_WIFI_INIT,
+    WAKE_PHASE_WIFI_WAIT_CONNECTED,
+    WAKE_PHASE_FETCH,
+    WAKE_PHASE_CONTROL_GPIO,
+    WAKE_PHASE_FLUSH,
+    WAKE_PHASE_WIFI_SHUTDOWN,
+    WAKE_PHASE_COUNT
+} wake_phase_t;
+
+// Only compile profiler functions if the feature is enabled
+#if HW_WAKE_PROFILER_ENABLED
+
+/**
+ * @brief Mark the start of a wake phase
+ *
+ * @param phase Phase being started
+ */
+void wake_profiler_begin(wake_phase_t phase);
+
+/**
+ * @brief Mark the end of a wake phase and add its duration to this wake's total
+ *
+ * Has no effect if wake_profiler_begin() was not called for this phase.
+ *
+ * @param phase Phase being finished
+ */
+void wake_profiler_end(wake_phase_t phase);
+
+/**
+ * @brief Record the unused stack of the task that ran a phase
+ *
+ * The smallest value is kept across wakes until wake_profiler_reset().
+ *
+ * @param phase Phase run by the task
+ * @param stack_size Stack size the task was created with (bytes)
+ * @param free_bytes Stack never used, from uxTaskGetStackHighWaterMark() (bytes)
+ */
+void wake_profiler_stack(wake_phase_t phase, uint32_t stack_size, uint32_t free_bytes);
+
+/**
+ * @brief Fold this wake's awake time and phase totals into the statistics and log a summary
+ *
+ * Should be called right before entering deep sleep.
+ */
+void wake_profiler_finish_wake(void);
+
+/**
+ * @brief Get the short name of a wake phase (e.g., "wifi_init")
+ *
+ * @param phase Wake phase
+ * @return Phase name, or "unknown" for out-of-range values
+ */
+const char *wake_profiler_phase_name(wake_phase_t phase);
+
+/**
+ * @brief Serialize accumulated statistics as a JSON object
+ *
+ * Format: {"wakes":N,"awake":{"min_ms":..,"avg_ms":..,"max_ms":..},
+ *          "phases":{"timezone_init":{"n":..,"min_ms":..,"avg_ms":..,"max_ms":..},...}}
+ * All durations are milliseconds with one decimal. Phases without samples are omitted.
+ * Phases with a recorded task stack add "stack" (size) and "stack_free" (smallest unused, bytes).
+ *
+ * @param buf Output buffer
+ * @param size Size of output buffer in bytes
+ * @return Number of characters written (excluding terminator), or -1 if buffer too small
+ */
+int wake_profiler_to_json(char *buf, size_t size);
+
+/**
+ * @brief Clear accumulated statistics (call after they have been shipped)
+ */
+void wake_profiler_reset(void);
+
+#else
+
+// Stub functions when the wake profiler is disabled (compile to nothing)
+static inline void wake_profiler_begin(wake_phase_t phase) { (void)phase; }
+static inline void wake_profiler_end(wake_phase_t phase) { (void)phase; }
+static inline void wake_profiler_stack(wake_phase_t phase, uint32_t stack_size, uint32_t free_bytes) {
+    (void)phase; (void)stack_size; (void)free_bytes;
+}
+static inline void wake_profiler_finish_wake(void) { }
+static inline const char *wake_profiler_phase_name(wake_phase_t phase) { (void)phase; return "unknown"; }
+static inline int wake_profiler_to_json(char *buf, size_t size) { if (buf && size) buf[0] = '\0'; return 0; }
+static inline void wake_profiler_reset(void) { }
+
+#endif // HW_WAKE_PROFILER_ENABLED
+
+#endif // WAKE_PROFILER_H
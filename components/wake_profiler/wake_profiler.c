@@ -0,0 +1,196 @@
+#include "wake_profiler.h"
+
+// Only compile this code if the wake profiler is enabled
+#if HW_WAKE_PROFILER_ENABLED
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "WAKE_PROFILER";
+
+// Accumulated duration statistics for one phase (microseconds)
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint16_t stack_size;         // Task stack of the phase (0 = not measured)
+    uint16_t stack_free;         // Smallest unused stack seen (bytes)
+    uint64_t sum_us;
+} phase_stats_t;
+
+static const char *PHASE_NAMES[WAKE_PHASE_COUNT] = {
+    "timezone_init",
+    "rtc_i2c_init",
+    "remote_logging_init",
+    "rgb_led_init",
+    "wait_until_target_second",
+    "wifi_init",
+    "wifi_wait_connected",
+    "fetch",
+    "control_gpio",
+    "flush",
+    "wifi_shutdown",
+};
+
+// RTC memory statistics persist during deep sleep (zeroed on power-on)
+RTC_DATA_ATTR static phase_stats_t s_phase_stats[WAKE_PHASE_COUNT];
+RTC_DATA_ATTR static phase_stats_t s_awake_stats;
+
+_Static_assert(sizeof(s_phase_stats) + sizeof(s_awake_stats) <= HW_RTC_BUDGET_WAKE_PROFILER,
+               "Phase statistics exceed HW_RTC_BUDGET_WAKE_PROFILER");
+
+// Per-wake state (regular RAM, reset on every boot)
+static int64_t s_phase_start_us[WAKE_PHASE_COUNT];
+static uint32_t s_phase_last_us[WAKE_PHASE_COUNT];
+static bool s_phase_seen[WAKE_PHASE_COUNT];
+static bool s_stack_seen[WAKE_PHASE_COUNT];
+
+static void stats_add(phase_stats_t *stats, uint32_t sample_us) {
+    if (stats->count == 0 || sample_us < stats->min_us) {
+        stats->min_us = sample_us;
+    }
+    if (sample_us > stats->max_us) {
+        stats->max_us = sample_us;
+    }
+    stats->sum_us += sample_us;
+    stats->count++;
+}
+
+static uint32_t stats_avg_us(const phase_stats_t *stats) {
+    return stats->count ? (uint32_t)(stats->sum_us / stats->count) : 0;
+}
+
+const char *wake_profiler_phase_name(wake_phase_t phase) {
+    if (phase < 0 || phase >= WAKE_PHASE_COUNT) {
+        return "unknown";
+    }
+    return PHASE_NAMES[phase];
+}
+
+void wake_profiler_begin(wake_phase_t phase) {
+    if (phase < 0 || phase >= WAKE_PHASE_COUNT) {
+        return;
+    }
+    s_phase_start_us[phase] = esp_timer_get_time();
+}
+
+void wake_profiler_end(wake_phase_t phase) {
+    if (phase < 0 || phase >= WAKE_PHASE_COUNT || s_phase_start_us[phase] == 0) {
+        return;
+    }
+
+    int64_t elapsed_us = esp_timer_get_time() - s_phase_start_us[phase];
+    s_phase_start_us[phase] = 0;
+    if (elapsed_us < 0) {
+        elapsed_us = 0;
+    }
+
+    // Phases may run more than once per wake (e.g., retries); the statistics get the sum for this wake
+    s_phase_last_us[phase] += (uint32_t)elapsed_us;
+    s_phase_seen[phase] = true;
+}
+
+void wake_profiler_stack(wake_phase_t phase, uint32_t stack_size, uint32_t free_bytes) {
+    if (phase < 0 || phase >= WAKE_PHASE_COUNT || stack_size == 0 || stack_size > UINT16_MAX) {
+        return;
+    }
+
+    phase_stats_t *stats = &s_phase_stats[phase];
+    if (stats->stack_size != stack_size || free_bytes < stats->stack_free) {
+        stats->stack_free = (uint16_t)(free_bytes < stack_size ? free_bytes : stack_size);
+    }
+    stats->stack_size = (uint16_t)stack_size;
+    s_stack_seen[phase] = true;
+}
+
+void wake_profiler_finish_wake(void) {
+    uint32_t awake_us = (uint32_t)esp_timer_get_time();
+    stats_add(&s_awake_stats, awake_us);
+    for (int i = 0; i < WAKE_PHASE_COUNT; i++) {
+        if (s_phase_seen[i]) {
+            stats_add(&s_phase_stats[i], s_phase_last_us[i]);
+        }
+    }
+
+    ESP_LOGI(TAG, "Awake for %lu ms (avg %lu ms over %lu wakes)",
+             (unsigned long)(awake_us / 1000),
+             (unsigned long)(stats_avg_us(&s_awake_stats) / 1000),
+             (unsigned long)s_awake_stats.count);
+
+    for (int i = 0; i < WAKE_PHASE_COUNT; i++) {
+        if (!s_phase_seen[i]) {
+            continue;
+        }
+        const phase_stats_t *stats = &s_phase_stats[i];
+        ESP_LOGI(TAG, "  %-24s %7lu ms (min %lu / avg %lu / max %lu ms)",
+                 PHASE_NAMES[i],
+                 (unsigned long)(s_phase_last_us[i] / 1000),
+                 (unsigned long)(stats->min_us / 1000),
+                 (unsigned long)(stats_avg_us(stats) / 1000),
+                 (unsigned long)(stats->max_us / 1000));
+        if (s_stack_seen[i]) {
+            ESP_LOGI(TAG, "  %-24s stack %u bytes, min %u bytes never used",
+                     "", (unsigned)stats->stack_size, (unsigned)stats->stack_free);
+        }
+    }
+}
+
+int wake_profiler_to_json(char *buf, size_t size) {
+    if (!buf || size == 0) {
+        return -1;
+    }
+
+    int offset = snprintf(buf, size,
+                          "{\"wakes\":%lu,\"awake\":{\"min_ms\":%.1f,\"avg_ms\":%.1f,\"max_ms\":%.1f},\"phases\":{",
+                          (unsigned long)s_awake_stats.count,
+                          s_awake_stats.min_us / 1000.0,
+                          stats_avg_us(&s_awake_stats) / 1000.0,
+                          s_awake_stats.max_us / 1000.0);
+
+    bool first = true;
+    for (int i = 0; i < WAKE_PHASE_COUNT && offset > 0 && (size_t)offset < size; i++) {
+        const phase_stats_t *stats = &s_phase_stats[i];
+        if (stats->count == 0) {
+            continue;
+        }
+        offset += snprintf(buf + offset, size - offset,
+                           "%s\"%s\":{\"n\":%lu,\"min_ms\":%.1f,\"avg_ms\":%.1f,\"max_ms\":%.1f",
+                           first ? "" : ",",
+                           PHASE_NAMES[i],
+                           (unsigned long)stats->count,
+                           stats->min_us / 1000.0,
+                           stats_avg_us(stats) / 1000.0,
+                           stats->max_us / 1000.0);
+        if (stats->stack_size > 0 && offset > 0 && (size_t)offset < size) {
+            offset += snprintf(buf + offset, size - offset, ",\"stack\":%u,\"stack_free\":%u",
+                               (unsigned)stats->stack_size, (unsigned)stats->stack_free);
+        }
+        if (offset > 0 && (size_t)offset < size) {
+            offset += snprintf(buf + offset, size - offset, "}");
+        }
+        first = false;
+    }
+
+    if (offset > 0 && (size_t)offset < size) {
+        offset += snprintf(buf + offset, size - offset, "}}");
+    }
+
+    if (offset < 0 || (size_t)offset >= size) {
+        ESP_LOGW(TAG, "Wake profile JSON truncated (buffer %u bytes)", (unsigned)size);
+        buf[0] = '\0';
+        return -1;
+    }
+    return offset;
+}
+
+void wake_profiler_reset(void) {
+    memset(s_phase_stats, 0, sizeof(s_phase_stats));
+    memset(&s_awake_stats, 0, sizeof(s_awake_stats));
+    ESP_LOGI(TAG, "Wake profile statistics reset");
+}
+
+#endif // HW_WAKE_PROFILER_ENABLED
@@ -85,9 +85,18 @@ void control_leds(const gpio_num_t *led_pins, int num_leds, bool mainPinActive,
     ESP_LOGI(TAG, "LED control: main_pin=%s, cloudcover=%.1f%%, active_leds=%d",
              mainPinActive ? "ON" : "OFF", cloudcover, activeLEDs);
 
+    control_led_count(led_pins, num_leds, activeLEDs);
+}
+
+void control_led_count(const gpio_num_t *led_pins, int num_leds, int active_leds) {
+    if (!led_pins) {
+        ESP_LOGE(TAG, "NULL led_pins pointer");
+        return;
+    }
+
     // Set LED states and configure GPIO pins
     for (int i = 0; i < num_leds; i++) {
-        bool ledOn = (i < activeLEDs);
+        bool ledOn = (i < active_leds);
         set_rtc_gpio_output(led_pins[i], ledOn ? 0 : 1);  // Active-low: 0=ON, 1=OFF
     }
 }
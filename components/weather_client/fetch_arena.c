@@ -0,0 +1,28 @@
+#include "fetch_arena.h"
+#include <string.h>
+
+void fetch_arena_init(fetch_arena_t *arena, void *buffer, size_t size) {
+    arena->base = buffer;
+    arena->size = size;
+    arena->used = 0;
+    arena->peak = 0;
+}
+
+void *fetch_arena_alloc(fetch_arena_t *arena, size_t size) {
+    size_t aligned = (size + FETCH_ARENA_ALIGN - 1) & ~(size_t)(FETCH_ARENA_ALIGN - 1);
+    if (aligned < size || aligned > arena->size - arena->used) {
+        return NULL;
+    }
+
+    void *ptr = arena->base + arena->used;
+    arena->used += aligned;
+    if (arena->used > arena->peak) {
+        arena->peak = arena->used;
+    }
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void fetch_arena_reset(fetch_arena_t *arena) {
+    arena->used = 0;
+}
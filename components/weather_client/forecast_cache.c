@@ -0,0 +1,65 @@
+#include "forecast_cache.h"
+#include <string.h>
+
+// The CRC covers everything from fetched_at on
+#define CRC_OFFSET offsetof(forecast_cache_t, fetched_at)
+
+uint32_t forecast_cache_crc32(const void *data, size_t len) {
+    const uint8_t *bytes = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t contents_crc(const forecast_cache_t *cache) {
+    return forecast_cache_crc32((const uint8_t *)cache + CRC_OFFSET, sizeof(*cache) - CRC_OFFSET);
+}
+
+bool forecast_cache_valid(const forecast_cache_t *cache) {
+    return cache->num_days > 0 && cache->num_days <= FORECAST_CACHE_DAYS && cache->crc == contents_crc(cache);
+}
+
+static void copy_header(char *dst, size_t size, const char *src) {
+    // Validators that do not fit are dropped rather than sent truncated
+    if (src && strlen(src) < size) {
+        strcpy(dst, src);
+    } else {
+        dst[0] = '\0';
+    }
+}
+
+void forecast_cache_store(forecast_cache_t *cache, const forecast_values_t *values, const char *from_date,
+                          int64_t fetched_at, uint32_t query_hash, const char *etag, const char *last_modified) {
+    memset(cache, 0, sizeof(*cache));
+    for (int i = 0; i < values->num_days && cache->num_days < FORECAST_CACHE_DAYS; i++) {
+        // ISO dates compare chronologically as strings
+        if (from_date && strcmp(values->days[i].date, from_date) < 0) {
+            continue;
+        }
+        cache->days[cache->num_days++] = values->days[i];
+    }
+    cache->fetched_at = fetched_at;
+    cache->query_hash = query_hash;
+    copy_header(cache->etag, sizeof(cache->etag), etag);
+    copy_header(cache->last_modified, sizeof(cache->last_modified), last_modified);
+    cache->crc = contents_crc(cache);
+}
+
+void forecast_cache_touch(forecast_cache_t *cache, int64_t fetched_at) {
+    cache->fetched_at = fetched_at;
+    cache->crc = contents_crc(cache);
+}
+
+const forecast_day_t *forecast_cache_find(const forecast_cache_t *cache, const char *date) {
+    for (int i = 0; i < cache->num_days; i++) {
+        if (strcmp(cache->days[i].date, date) == 0) {
+            return &cache->days[i];
+        }
+    }
+    return NULL;
+}
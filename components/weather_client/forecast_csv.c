@@ -0,0 +1,152 @@
+#include "forecast_csv.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Block types
+enum {
+    BLOCK_OTHER = 0,    // Location metadata or unknown block
+    BLOCK_HOURLY,
+    BLOCK_DAILY,
+};
+
+// Find field number `column` of the line; returns its length
+static size_t get_field(const char *line, size_t line_len, int column, const char **field) {
+    size_t start = 0;
+    for (int i = 0; i < column; i++) {
+        const char *comma = memchr(line + start, ',', line_len - start);
+        if (!comma) {
+            *field = NULL;
+            return 0;
+        }
+        start = (size_t)(comma - line) + 1;
+    }
+    const char *comma = memchr(line + start, ',', line_len - start);
+    *field = line + start;
+    return comma ? (size_t)(comma - (line + start)) : line_len - start;
+}
+
+// "time,..." header row: locate the columns we need
+static void header_row(forecast_csv_parser_t *p) {
+    p->cloudcover_column = -1;
+    p->sunrise_column = -1;
+    p->sunset_column = -1;
+
+    for (int column = 1;; column++) {
+        const char *field;
+        size_t len = get_field(p->line, p->line_len, column, &field);
+        if (!field) {
+            break;
+        }
+        if (len >= 10 && strncmp(field, "cloudcover", 10) == 0) {
+            p->cloudcover_column = (int8_t)column;
+        } else if (len >= 7 && strncmp(field, "sunrise", 7) == 0) {
+            p->sunrise_column = (int8_t)column;
+        } else if (len >= 6 && strncmp(field, "sunset", 6) == 0) {
+            p->sunset_column = (int8_t)column;
+        }
+    }
+
+    if (p->sunrise_column >= 0 || p->sunset_column >= 0) {
+        p->block = BLOCK_DAILY;
+    } else if (p->cloudcover_column >= 0) {
+        p->block = BLOCK_HOURLY;
+    } else {
+        p->block = BLOCK_OTHER;
+    }
+    p->row = 0;
+}
+
+static void data_row(forecast_csv_parser_t *p) {
+    const char *field;
+    size_t len = get_field(p->line, p->line_len, 0, &field);
+
+    if (p->block == BLOCK_HOURLY) {
+        forecast_values_hour_time(&p->values, p->row, field, len);
+        len = get_field(p->line, p->line_len, p->cloudcover_column, &field);
+        if (field && len > 0 && field[0] >= '0' && field[0] <= '9') {
+            // Empty if missing; the line buffer is terminated, strtof stops at the next comma
+            forecast_values_hour_cloudcover(&p->values, p->row, strtof(field, NULL));
+        }
+    } else {
+        forecast_values_day_time(&p->values, p->row, field, len);
+        if (p->sunrise_column >= 0) {
+            len = get_field(p->line, p->line_len, p->sunrise_column, &field);
+            if (field) {
+                forecast_values_day_sunrise(&p->values, p->row, field, len);
+            }
+        }
+        if (p->sunset_column >= 0) {
+            len = get_field(p->line, p->line_len, p->sunset_column, &field);
+            if (field) {
+                forecast_values_day_sunset(&p->values, p->row, field, len);
+            }
+        }
+    }
+    p->row++;
+}
+
+// Location metadata: "latitude,...,utc_offset_seconds,..." header, then one row of values
+static void location_row(forecast_csv_parser_t *p) {
+    const char *field;
+    if (strncmp(p->line, "latitude,", 9) == 0) {
+        p->utc_offset_column = -1;
+        for (int column = 1;; column++) {
+            size_t len = get_field(p->line, p->line_len, column, &field);
+            if (!field) {
+                break;
+            }
+            if (len == 18 && strncmp(field, "utc_offset_seconds", 18) == 0) {
+                p->utc_offset_column = (int8_t)column;
+            }
+        }
+    } else if (p->utc_offset_column >= 0) {
+        size_t len = get_field(p->line, p->line_len, p->utc_offset_column, &field);
+        if (field && len > 0) {
+            // The line buffer is terminated, strtol stops at the next comma
+            forecast_values_utc_offset(&p->values, (int32_t)strtol(field, NULL, 10));
+        }
+        p->utc_offset_column = -1;
+    }
+}
+
+static void handle_line(forecast_csv_parser_t *p) {
+    p->line[p->line_len] = '\0';
+
+    if (p->line_len == 0) {
+        p->block = BLOCK_OTHER;
+    } else if (strncmp(p->line, "time,", 5) == 0) {
+        header_row(p);
+    } else if (p->block != BLOCK_OTHER) {
+        data_row(p);
+    } else {
+        location_row(p);
+    }
+    p->line_len = 0;
+}
+
+void forecast_csv_init(forecast_csv_parser_t *parser, const char *target_date) {
+    memset(parser, 0, sizeof(*parser));
+    parser->block = BLOCK_OTHER;
+    parser->utc_offset_column = -1;
+    forecast_values_init(&parser->values, target_date);
+}
+
+bool forecast_csv_feed(forecast_csv_parser_t *parser, const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            handle_line(parser);
+        } else if (c != '\r' && parser->line_len < FORECAST_CSV_LINE_SIZE - 1) {
+            parser->line[parser->line_len++] = c;
+        }
+    }
+    return true;
+}
+
+forecast_parse_result_t forecast_csv_finish(forecast_csv_parser_t *parser, weather_data_t *weather_data) {
+    // Last row without a trailing newline
+    if (parser->line_len > 0) {
+        handle_line(parser);
+    }
+    return forecast_values_finish(&parser->values, weather_data);
+}
@@ -0,0 +1,62 @@
+#include "forecast_decision.h"
+#include <stdio.h>
+#include <string.h>
+
+uint16_t forecast_decision_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Civil date from days since 1970-01-01 (proleptic Gregorian calendar)
+static void civil_from_days(long days, int *year, int *month, int *day) {
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    long doe = days - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    *day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *year = (int)(yoe + era * 400 + (*month <= 2 ? 1 : 0));
+}
+
+forecast_decision_result_t forecast_decision_decode(const uint8_t *data, size_t len, forecast_decision_t *decision) {
+    if (len != FORECAST_DECISION_SIZE) {
+        return FORECAST_DECISION_ERR_SIZE;
+    }
+    uint16_t crc = (uint16_t)(data[30] | (data[31] << 8));
+    if (forecast_decision_crc16(data, 30) != crc) {
+        return FORECAST_DECISION_ERR_CRC;
+    }
+    if (data[0] != FORECAST_DECISION_VERSION) {
+        return FORECAST_DECISION_ERR_VERSION;
+    }
+    if (data[1] > 23 || data[5] > 200) {
+        return FORECAST_DECISION_ERR_RANGE;
+    }
+
+    memset(decision, 0, sizeof(*decision));
+
+    // 2000-01-01 is day 10957 since 1970-01-01
+    int year, month, day;
+    civil_from_days(10957L + (data[2] | (data[3] << 8)), &year, &month, &day);
+    snprintf(decision->day.date, sizeof(decision->day.date), "%04d-%02d-%02d", year, month, day);
+
+    for (int hour = 0; hour < 24; hour++) {
+        uint8_t value = data[6 + hour];
+        decision->day.cloudcover[hour] = (value <= 100) ? value : FORECAST_CLOUDCOVER_UNKNOWN;
+    }
+    decision->day.sunrise_minutes = -1;
+    decision->day.sunset_minutes = -1;
+
+    decision->pin_off_hour = data[1];
+    decision->led_count = data[4];
+    decision->avg_cloudcover = data[5] * 0.5f;
+    return FORECAST_DECISION_OK;
+}
@@ -0,0 +1,68 @@
+#include "forecast_format.h"
+
+// Parser entry points of one format
+typedef struct {
+    const char *name;
+    const char *query_value;
+    void (*init)(void *parser, const char *target_date);
+    bool (*feed)(void *parser, const char *data, size_t len);
+    forecast_parse_result_t (*finish)(void *parser, weather_data_t *weather_data);
+} forecast_format_ops_t;
+
+static void json_init(void *parser, const char *target_date) {
+    forecast_parser_init(parser, target_date);
+}
+
+static bool json_feed(void *parser, const char *data, size_t len) {
+    return forecast_parser_feed(parser, data, len);
+}
+
+static forecast_parse_result_t json_finish(void *parser, weather_data_t *weather_data) {
+    return forecast_parser_finish(parser, weather_data);
+}
+
+static void csv_init(void *parser, const char *target_date) {
+    forecast_csv_init(parser, target_date);
+}
+
+static bool csv_feed(void *parser, const char *data, size_t len) {
+    return forecast_csv_feed(parser, data, len);
+}
+
+static forecast_parse_result_t csv_finish(void *parser, weather_data_t *weather_data) {
+    return forecast_csv_finish(parser, weather_data);
+}
+
+static const forecast_format_ops_t FORMATS[] = {
+    [FORECAST_FORMAT_JSON] = {"json", NULL, json_init, json_feed, json_finish},
+    [FORECAST_FORMAT_CSV] = {"csv", "csv", csv_init, csv_feed, csv_finish},
+};
+
+static const forecast_format_ops_t *format_ops(forecast_format_t format) {
+    return (format == FORECAST_FORMAT_CSV) ? &FORMATS[FORECAST_FORMAT_CSV] : &FORMATS[FORECAST_FORMAT_JSON];
+}
+
+const char *forecast_format_query_value(forecast_format_t format) {
+    return format_ops(format)->query_value;
+}
+
+const char *forecast_format_name(forecast_format_t format) {
+    return format_ops(format)->name;
+}
+
+void forecast_decoder_init(forecast_decoder_t *decoder, forecast_format_t format, const char *target_date) {
+    decoder->format = format;
+    format_ops(format)->init(&decoder->parser, target_date);
+}
+
+bool forecast_decoder_feed(forecast_decoder_t *decoder, const char *data, size_t len) {
+    return format_ops(decoder->format)->feed(&decoder->parser, data, len);
+}
+
+forecast_parse_result_t forecast_decoder_finish(forecast_decoder_t *decoder, weather_data_t *weather_data) {
+    return format_ops(decoder->format)->finish(&decoder->parser, weather_data);
+}
+
+forecast_values_t *forecast_decoder_values(forecast_decoder_t *decoder) {
+    return (decoder->format == FORECAST_FORMAT_CSV) ? &decoder->parser.csv.values : &decoder->parser.json.values;
+}
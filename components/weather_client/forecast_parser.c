@@ -0,0 +1,286 @@
+#include "forecast_parser.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Tokenizer states
+enum {
+    LEX_IDLE = 0,
+    LEX_STRING,
+    LEX_STRING_ESCAPE,
+    LEX_NUMBER,
+    LEX_LITERAL,
+};
+
+// What the grammar allows next
+enum {
+    EXPECT_VALUE = 0,
+    EXPECT_VALUE_OR_END,    // Right after '['
+    EXPECT_KEY,
+    EXPECT_KEY_OR_END,      // Right after '{'
+    EXPECT_COLON,
+    EXPECT_COMMA_OR_END,
+    EXPECT_EOF,             // Root value complete
+};
+
+// Keys on the paths we extract
+enum {
+    KEY_OTHER = 0,
+    KEY_HOURLY,
+    KEY_DAILY,
+    KEY_TIME,
+    KEY_CLOUDCOVER,
+    KEY_SUNRISE,
+    KEY_SUNSET,
+    KEY_UTC_OFFSET,
+};
+
+static uint8_t match_key(const char *token) {
+    if (strcmp(token, "hourly") == 0) return KEY_HOURLY;
+    if (strcmp(token, "daily") == 0) return KEY_DAILY;
+    if (strcmp(token, "time") == 0) return KEY_TIME;
+    if (strcmp(token, "cloudcover") == 0) return KEY_CLOUDCOVER;
+    if (strcmp(token, "sunrise") == 0) return KEY_SUNRISE;
+    if (strcmp(token, "sunset") == 0) return KEY_SUNSET;
+    if (strcmp(token, "utc_offset_seconds") == 0) return KEY_UTC_OFFSET;
+    return KEY_OTHER;
+}
+
+static void token_append(forecast_parser_t *p, char c) {
+    if (p->token_len < FORECAST_PARSER_TOKEN_SIZE - 1) {
+        p->token[p->token_len++] = c;
+    }
+}
+
+static void token_start(forecast_parser_t *p) {
+    p->token_len = 0;
+}
+
+static void token_end(forecast_parser_t *p) {
+    p->token[p->token_len] = '\0';
+}
+
+// Location of the current value: section.field[index], e.g. hourly.time[5]
+static bool value_path(const forecast_parser_t *p, uint8_t *section, uint8_t *field, int *index) {
+    if (p->depth != 3 || p->stack[0].is_array || p->stack[1].is_array || !p->stack[2].is_array) {
+        return false;
+    }
+    *section = p->stack[0].key;
+    *field = p->stack[1].key;
+    *index = p->stack[2].index;
+    return true;
+}
+
+static void handle_string(forecast_parser_t *p) {
+    uint8_t section, field;
+    int index;
+    if (!value_path(p, &section, &field, &index)) {
+        return;
+    }
+
+    if (section == KEY_HOURLY && field == KEY_TIME) {
+        forecast_values_hour_time(&p->values, index, p->token, p->token_len);
+    } else if (section == KEY_DAILY && field == KEY_TIME) {
+        forecast_values_day_time(&p->values, index, p->token, p->token_len);
+    } else if (section == KEY_DAILY && field == KEY_SUNRISE) {
+        forecast_values_day_sunrise(&p->values, index, p->token, p->token_len);
+    } else if (section == KEY_DAILY && field == KEY_SUNSET) {
+        forecast_values_day_sunset(&p->values, index, p->token, p->token_len);
+    }
+}
+
+static void handle_number(forecast_parser_t *p) {
+    uint8_t section, field;
+    int index;
+    if (value_path(p, &section, &field, &index) && section == KEY_HOURLY && field == KEY_CLOUDCOVER) {
+        forecast_values_hour_cloudcover(&p->values, index, strtof(p->token, NULL));
+    } else if (p->depth == 1 && !p->stack[0].is_array && p->stack[0].key == KEY_UTC_OFFSET) {
+        // Top-level utc_offset_seconds
+        forecast_values_utc_offset(&p->values, (int32_t)strtol(p->token, NULL, 10));
+    }
+}
+
+// A value (scalar or container) at the current level is complete
+static void value_done(forecast_parser_t *p) {
+    p->expect = (p->depth == 0) ? EXPECT_EOF : EXPECT_COMMA_OR_END;
+}
+
+static void push(forecast_parser_t *p, bool is_array) {
+    if (p->depth >= FORECAST_PARSER_MAX_DEPTH) {
+        p->error = true;
+        return;
+    }
+    forecast_parser_level_t *level = &p->stack[p->depth++];
+    level->is_array = is_array;
+    level->key = KEY_OTHER;
+    level->index = 0;
+    p->expect = is_array ? EXPECT_VALUE_OR_END : EXPECT_KEY_OR_END;
+}
+
+static void pop(forecast_parser_t *p, bool is_array) {
+    if (p->depth == 0 || p->stack[p->depth - 1].is_array != is_array) {
+        p->error = true;
+        return;
+    }
+    p->depth--;
+    value_done(p);
+}
+
+// Handle one character outside strings, numbers and literals
+static void structural(forecast_parser_t *p, char c) {
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        return;
+    }
+
+    switch (p->expect) {
+        case EXPECT_VALUE:
+        case EXPECT_VALUE_OR_END:
+            if (c == '{') {
+                push(p, false);
+            } else if (c == '[') {
+                push(p, true);
+            } else if (c == '"') {
+                token_start(p);
+                p->token_is_key = false;
+                p->lex_state = LEX_STRING;
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                token_start(p);
+                token_append(p, c);
+                p->lex_state = LEX_NUMBER;
+            } else if (c >= 'a' && c <= 'z') {
+                token_start(p);
+                token_append(p, c);
+                p->lex_state = LEX_LITERAL;
+            } else if (c == ']' && p->expect == EXPECT_VALUE_OR_END) {
+                pop(p, true);
+            } else {
+                p->error = true;
+            }
+            break;
+
+        case EXPECT_KEY:
+        case EXPECT_KEY_OR_END:
+            if (c == '"') {
+                token_start(p);
+                p->token_is_key = true;
+                p->lex_state = LEX_STRING;
+            } else if (c == '}' && p->expect == EXPECT_KEY_OR_END) {
+                pop(p, false);
+            } else {
+                p->error = true;
+            }
+            break;
+
+        case EXPECT_COLON:
+            if (c == ':') {
+                p->expect = EXPECT_VALUE;
+            } else {
+                p->error = true;
+            }
+            break;
+
+        case EXPECT_COMMA_OR_END: {
+            forecast_parser_level_t *level = &p->stack[p->depth - 1];
+            if (c == ',') {
+                if (level->is_array) {
+                    level->index++;
+                    p->expect = EXPECT_VALUE;
+                } else {
+                    p->expect = EXPECT_KEY;
+                }
+            } else if (c == ']' || c == '}') {
+                pop(p, c == ']');
+            } else {
+                p->error = true;
+            }
+            break;
+        }
+
+        default:
+            p->error = true;
+            break;
+    }
+}
+
+void forecast_parser_init(forecast_parser_t *parser, const char *target_date) {
+    memset(parser, 0, sizeof(*parser));
+    parser->lex_state = LEX_IDLE;
+    parser->expect = EXPECT_VALUE;
+    forecast_values_init(&parser->values, target_date);
+}
+
+bool forecast_parser_feed(forecast_parser_t *parser, const char *data, size_t len) {
+    forecast_parser_t *p = parser;
+
+    for (size_t i = 0; i < len && !p->error; i++) {
+        char c = data[i];
+
+        switch (p->lex_state) {
+            case LEX_STRING:
+                if (c == '\\') {
+                    p->lex_state = LEX_STRING_ESCAPE;
+                } else if (c == '"') {
+                    token_end(p);
+                    p->lex_state = LEX_IDLE;
+                    if (p->token_is_key) {
+                        p->stack[p->depth - 1].key = match_key(p->token);
+                        p->expect = EXPECT_COLON;
+                    } else {
+                        handle_string(p);
+                        value_done(p);
+                    }
+                } else {
+                    token_append(p, c);
+                }
+                continue;
+
+            case LEX_STRING_ESCAPE:
+                // Escapes never occur in the values we extract; keep the raw character
+                token_append(p, c);
+                p->lex_state = LEX_STRING;
+                continue;
+
+            case LEX_NUMBER:
+                if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+                    token_append(p, c);
+                    continue;
+                }
+                token_end(p);
+                p->lex_state = LEX_IDLE;
+                handle_number(p);
+                value_done(p);
+                break;  // The terminating character is structural
+
+            case LEX_LITERAL:
+                if (c >= 'a' && c <= 'z') {
+                    token_append(p, c);
+                    continue;
+                }
+                token_end(p);
+                p->lex_state = LEX_IDLE;
+                if (strcmp(p->token, "true") != 0 && strcmp(p->token, "false") != 0 &&
+                    strcmp(p->token, "null") != 0) {
+                    p->error = true;
+                    continue;
+                }
+                value_done(p);
+                break;  // The terminating character is structural
+
+            default:
+                break;
+        }
+
+        structural(p, c);
+    }
+
+    return !p->error;
+}
+
+forecast_parse_result_t forecast_parser_finish(forecast_parser_t *parser, weather_data_t *weather_data) {
+    forecast_parse_result_t result = forecast_values_finish(&parser->values, weather_data);
+
+    if (parser->error || parser->expect != EXPECT_EOF) {
+        weather_data->valid = false;
+        return parser->error ? FORECAST_PARSE_ERR_SYNTAX : FORECAST_PARSE_ERR_INCOMPLETE;
+    }
+    return result;
+}
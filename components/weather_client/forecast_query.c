@@ -0,0 +1,30 @@
+#include "forecast_query.h"
+#include <stdio.h>
+
+int forecast_query_build(const forecast_query_t *query, char *buf, size_t size) {
+    // Today plus the requested days: no dates in the path, so it does not change at midnight
+    int len = snprintf(buf, size,
+                       "/v1/forecast?latitude=%.2f&longitude=%.2f&hourly=cloudcover&timezone=auto&forecast_days=%d",
+                       query->latitude, query->longitude, 1 + ((query->days > 1) ? query->days : 1));
+
+    const char *format = forecast_format_query_value(query->format);
+    if (format && len >= 0 && (size_t)len < size) {
+        len += snprintf(buf + len, size - len, "&format=%s", format);
+    }
+    return len;
+}
+
+void forecast_query_next_date(int year, int month, int day, char *buf, size_t size) {
+    static const int DAYS_IN_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    int month_days = (month == 2 && leap) ? 29 : DAYS_IN_MONTH[(month - 1) % 12];
+
+    if (++day > month_days) {
+        day = 1;
+        if (++month > 12) {
+            month = 1;
+            year++;
+        }
+    }
+    snprintf(buf, size, "%04d-%02d-%02d", year, month, day);
+}
@@ -0,0 +1,178 @@
+#include "forecast_values.h"
+#include <math.h>
+#include <string.h>
+
+// Parse "HH:MM" at offset 11 of an ISO 8601 timestamp ("2025-10-20T07:10")
+static bool parse_time_of_day(const char *timestamp, size_t len, int *hour, int *minute) {
+    if (len < 16 || timestamp[10] != 'T' || timestamp[13] != ':') {
+        return false;
+    }
+    *hour = (timestamp[11] - '0') * 10 + (timestamp[12] - '0');
+    *minute = (timestamp[14] - '0') * 10 + (timestamp[15] - '0');
+    return true;
+}
+
+// Slot of the day with this date, added if new (-1 if all slots are taken)
+static int day_slot(forecast_values_t *v, const char *date) {
+    for (int i = 0; i < v->num_days; i++) {
+        if (strncmp(v->days[i].date, date, 10) == 0) {
+            return i;
+        }
+    }
+    if (v->num_days >= FORECAST_MAX_DAYS) {
+        return -1;
+    }
+
+    forecast_day_t *day = &v->days[v->num_days];
+    memcpy(day->date, date, 10);
+    day->date[10] = '\0';
+    memset(day->cloudcover, FORECAST_CLOUDCOVER_UNKNOWN, sizeof(day->cloudcover));
+    day->sunrise_minutes = -1;
+    day->sunset_minutes = -1;
+    return v->num_days++;
+}
+
+void forecast_values_init(forecast_values_t *values, const char *target_date) {
+    memset(values, 0, sizeof(*values));
+    memset(values->hour_slot, -1, sizeof(values->hour_slot));
+    memset(values->daily_slot, -1, sizeof(values->daily_slot));
+    if (target_date) {
+        strncpy(values->target_date, target_date, sizeof(values->target_date) - 1);
+    }
+}
+
+void forecast_values_hour_time(forecast_values_t *values, int index, const char *timestamp, size_t len) {
+    int hour, minute;
+    if (index < 0 || index >= FORECAST_MAX_HOURS || !parse_time_of_day(timestamp, len, &hour, &minute) ||
+        hour < 0 || hour > 23) {
+        return;
+    }
+
+    if (values->first_date[0] == '\0') {
+        memcpy(values->first_date, timestamp, 10);
+    }
+    values->hour_slot[index] = (int8_t)day_slot(values, timestamp);
+    values->hour_of_day[index] = (int8_t)hour;
+}
+
+void forecast_values_hour_cloudcover(forecast_values_t *values, int index, float cloudcover) {
+    if (index < 0 || index >= FORECAST_MAX_HOURS || values->hour_slot[index] < 0 || isnan(cloudcover)) {
+        return;
+    }
+
+    // Open-Meteo reports whole percent; clamp and round anything else
+    float clamped = (cloudcover < 0.0f) ? 0.0f : (cloudcover > 100.0f) ? 100.0f : cloudcover;
+    values->days[values->hour_slot[index]].cloudcover[values->hour_of_day[index]] = (uint8_t)(clamped + 0.5f);
+}
+
+void forecast_values_utc_offset(forecast_values_t *values, int32_t seconds) {
+    // Real offsets are within -12 h and +14 h
+    if (seconds >= -14 * 3600 && seconds <= 14 * 3600) {
+        values->utc_offset_seconds = seconds;
+        values->has_utc_offset = true;
+    }
+}
+
+void forecast_values_day_time(forecast_values_t *values, int index, const char *date, size_t len) {
+    if (index >= 0 && index < FORECAST_MAX_DAYS && len >= 10) {
+        values->daily_slot[index] = (int8_t)day_slot(values, date);
+    }
+}
+
+void forecast_values_day_sunrise(forecast_values_t *values, int index, const char *timestamp, size_t len) {
+    int hour, minute;
+    if (index >= 0 && index < FORECAST_MAX_DAYS && values->daily_slot[index] >= 0 &&
+        parse_time_of_day(timestamp, len, &hour, &minute)) {
+        values->days[values->daily_slot[index]].sunrise_minutes = (int16_t)(hour * 60 + minute);
+    }
+}
+
+void forecast_values_day_sunset(forecast_values_t *values, int index, const char *timestamp, size_t len) {
+    int hour, minute;
+    if (index >= 0 && index < FORECAST_MAX_DAYS && values->daily_slot[index] >= 0 &&
+        parse_time_of_day(timestamp, len, &hour, &minute)) {
+        values->days[values->daily_slot[index]].sunset_minutes = (int16_t)(hour * 60 + minute);
+    }
+}
+
+const forecast_day_t *forecast_values_tomorrow(const forecast_values_t *values) {
+    for (int i = 0; i < values->num_days; i++) {
+        const char *date = values->days[i].date;
+        bool tomorrow = values->target_date[0] ? strcmp(date, values->target_date) == 0
+                                               : strncmp(date, values->first_date, 10) != 0;
+        if (tomorrow) {
+            return &values->days[i];
+        }
+    }
+    return NULL;
+}
+
+forecast_parse_result_t forecast_values_finish(forecast_values_t *values, weather_data_t *weather_data) {
+    const forecast_day_t *tomorrow = forecast_values_tomorrow(values);
+    forecast_parse_result_t result = forecast_day_summarize(tomorrow, weather_data,
+                                                            &values->window_start_hour, &values->window_end_hour);
+    if (!tomorrow && values->target_date[0]) {
+        memcpy(weather_data->tomorrow_date, values->target_date, sizeof(weather_data->tomorrow_date));
+    }
+    return result;
+}
+
+forecast_parse_result_t forecast_day_summarize(const forecast_day_t *day, weather_data_t *weather_data,
+                                               int *window_start_hour, int *window_end_hour) {
+    memset(weather_data, 0, sizeof(*weather_data));
+    weather_data->valid = false;
+    weather_data->sunrise_hour = -1;
+    weather_data->sunrise_minute = -1;
+    weather_data->sunset_hour = -1;
+    weather_data->sunset_minute = -1;
+
+    // Default to 6 AM - 6 PM if sunrise/sunset are missing
+    int start_hour = 6;
+    int end_hour = 18;
+    if (day && day->sunrise_minutes >= 0) {
+        weather_data->sunrise_hour = day->sunrise_minutes / 60;
+        weather_data->sunrise_minute = day->sunrise_minutes % 60;
+        // Round up: if minute >= 30, add 2 hours; otherwise add 1 hour
+        start_hour = weather_data->sunrise_hour + ((weather_data->sunrise_minute >= 30) ? 2 : 1);
+    }
+    if (day && day->sunset_minutes >= 0) {
+        weather_data->sunset_hour = day->sunset_minutes / 60;
+        weather_data->sunset_minute = day->sunset_minutes % 60;
+        end_hour = weather_data->sunset_hour - 1;
+    }
+    if (window_start_hour) {
+        *window_start_hour = start_hour;
+    }
+    if (window_end_hour) {
+        *window_end_hour = end_hour;
+    }
+    if (!day) {
+        return FORECAST_PARSE_ERR_NO_DATA;
+    }
+    memcpy(weather_data->tomorrow_date, day->date, sizeof(weather_data->tomorrow_date));
+
+    // Average the day's cloud cover over the daytime window
+    float cloudcover_sum = 0.0f;
+    int daytime_count = 0;
+    for (int hour = (start_hour < 0) ? 0 : start_hour; hour <= end_hour && hour < 24; hour++) {
+        if (day->cloudcover[hour] == FORECAST_CLOUDCOVER_UNKNOWN) {
+            continue;
+        }
+
+        cloudcover_sum += day->cloudcover[hour];
+        if (daytime_count < MAX_DAYTIME_HOURS) {
+            weather_data->daytime_hours[daytime_count] = hour;
+            weather_data->hourly_cloudcover[daytime_count] = day->cloudcover[hour];
+        }
+        daytime_count++;
+    }
+    weather_data->num_daytime_hours = (daytime_count < MAX_DAYTIME_HOURS) ? daytime_count : MAX_DAYTIME_HOURS;
+
+    if (daytime_count == 0) {
+        return FORECAST_PARSE_ERR_NO_DATA;
+    }
+
+    weather_data->tomorrow_cloudcover = cloudcover_sum / daytime_count;
+    weather_data->valid = true;
+    return FORECAST_PARSE_OK;
+}
@@ -0,0 +1,159 @@
+#include "gzip_stream.h"
+#include <string.h>
+
+// gzip header (RFC 1952): fixed part, then optional fields selected by FLG
+enum {
+    HDR_FIXED = 0,      // ID1 ID2 CM FLG MTIME(4) XFL OS
+    HDR_EXTRA_LEN,      // FEXTRA: 2-byte length
+    HDR_EXTRA,          // FEXTRA: data
+    HDR_NAME,           // FNAME: zero-terminated
+    HDR_COMMENT,        // FCOMMENT: zero-terminated
+    HDR_CRC,            // FHCRC: 2 bytes
+    HDR_DONE,           // Deflate data follows
+    STREAM_END,         // Final deflate block inflated
+};
+
+#define GZIP_FIXED_HEADER_SIZE 10
+
+#define FLG_FHCRC    0x02
+#define FLG_FEXTRA   0x04
+#define FLG_FNAME    0x08
+#define FLG_FCOMMENT 0x10
+#define FLG_RESERVED 0xe0
+
+// Next header state after the current optional field
+static uint8_t next_header_state(const gzip_stream_t *s, uint8_t state) {
+    if (state < HDR_EXTRA_LEN && (s->flags & FLG_FEXTRA)) return HDR_EXTRA_LEN;
+    if (state < HDR_NAME && (s->flags & FLG_FNAME)) return HDR_NAME;
+    if (state < HDR_COMMENT && (s->flags & FLG_FCOMMENT)) return HDR_COMMENT;
+    if (state < HDR_CRC && (s->flags & FLG_FHCRC)) return HDR_CRC;
+    return HDR_DONE;
+}
+
+// Consume one header byte
+static void header_byte(gzip_stream_t *s, uint8_t c) {
+    switch (s->header_state) {
+        case HDR_FIXED: {
+            size_t pos = GZIP_FIXED_HEADER_SIZE - s->count;
+            if ((pos == 0 && c != 0x1f) || (pos == 1 && c != 0x8b) || (pos == 2 && c != 8) ||
+                (pos == 3 && (c & FLG_RESERVED))) {
+                s->error = true;
+                return;
+            }
+            if (pos == 3) {
+                s->flags = c;
+            }
+            if (--s->count == 0) {
+                s->header_state = next_header_state(s, HDR_FIXED);
+                s->count = 2;
+            }
+            break;
+        }
+
+        case HDR_EXTRA_LEN:
+            // Little endian: low byte first
+            if (s->count == 2) {
+                s->count = 1;
+                s->extra_len_low = c;
+            } else {
+                s->count = (uint16_t)(s->extra_len_low | (c << 8));
+                s->header_state = HDR_EXTRA;
+                if (s->count == 0) {
+                    s->header_state = next_header_state(s, HDR_EXTRA);
+                    s->count = 2;
+                }
+            }
+            break;
+
+        case HDR_EXTRA:
+            if (--s->count == 0) {
+                s->header_state = next_header_state(s, HDR_EXTRA);
+                s->count = 2;
+            }
+            break;
+
+        case HDR_NAME:
+        case HDR_COMMENT:
+            if (c == 0) {
+                s->header_state = next_header_state(s, s->header_state);
+                s->count = 2;
+            }
+            break;
+
+        case HDR_CRC:
+            if (--s->count == 0) {
+                s->header_state = HDR_DONE;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (s->header_state == HDR_DONE) {
+        tinfl_init(&s->inflator);
+    }
+}
+
+// Inflate the chunk, passing output on as the ring buffer fills
+static void inflate_chunk(gzip_stream_t *s, const uint8_t *data, size_t len) {
+    size_t pos = 0;
+
+    while (!s->error) {
+        size_t in_bytes = len - pos;
+        size_t out_bytes = TINFL_LZ_DICT_SIZE - s->dict_offset;
+        tinfl_status status = tinfl_decompress(&s->inflator, data + pos, &in_bytes,
+                                               s->dict, s->dict + s->dict_offset, &out_bytes,
+                                               TINFL_FLAG_HAS_MORE_INPUT);
+        pos += in_bytes;
+
+        if (out_bytes > 0) {
+            s->on_output((const char *)s->dict + s->dict_offset, out_bytes, s->ctx);
+            s->total_out += out_bytes;
+            s->dict_offset = (s->dict_offset + out_bytes) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+
+        if (status == TINFL_STATUS_DONE) {
+            s->header_state = STREAM_END;
+            break;
+        }
+        if (status < TINFL_STATUS_DONE) {
+            s->error = true;
+            break;
+        }
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+            break;
+        }
+        // TINFL_STATUS_HAS_MORE_OUTPUT: ring buffer wrapped, keep going
+    }
+}
+
+void gzip_stream_init(gzip_stream_t *stream, gzip_stream_output_cb_t on_output, void *ctx) {
+    memset(stream, 0, sizeof(*stream));
+    stream->header_state = HDR_FIXED;
+    stream->count = GZIP_FIXED_HEADER_SIZE;
+    stream->on_output = on_output;
+    stream->ctx = ctx;
+}
+
+bool gzip_stream_feed(gzip_stream_t *stream, const uint8_t *data, size_t len) {
+    gzip_stream_t *s = stream;
+    size_t pos = 0;
+
+    while (pos < len && !s->error && s->header_state < HDR_DONE) {
+        header_byte(s, data[pos++]);
+    }
+    if (pos < len && !s->error && s->header_state == HDR_DONE) {
+        inflate_chunk(s, data + pos, len - pos);
+    }
+
+    s->total_in += len;
+    return !s->error;
+}
+
+gzip_stream_result_t gzip_stream_finish(const gzip_stream_t *stream) {
+    if (stream->error) {
+        return GZIP_STREAM_ERR_FORMAT;
+    }
+    return (stream->header_state == STREAM_END) ? GZIP_STREAM_OK : GZIP_STREAM_ERR_INCOMPLETE;
+}
@@ -0,0 +1,480 @@
+// Session IDs are private fields in mbedTLS 3.x (esp-tls does the same)
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+
+#include "https_stream.h"
+#include "fetch_arena.h"
+#include "gzip_stream.h"
+#include "hardware_config.h"
+#include "power_profile.h"
+#include "esp_attr.h"
+#include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/ssl.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *TAG = "HTTPS_STREAM";
+
+// Serialized TLS session of the last successful connection (persists during deep sleep)
+typedef struct {
+    bool valid;
+    char host[48];
+    uint16_t len;
+    uint8_t data[HW_TLS_SESSION_CACHE_SIZE];
+} tls_session_cache_t;
+
+RTC_DATA_ATTR static tls_session_cache_t s_session_cache;
+
+_Static_assert(sizeof(s_session_cache) <= HW_RTC_BUDGET_TLS_SESSION,
+               "HW_TLS_SESSION_CACHE_SIZE exceeds HW_RTC_BUDGET_TLS_SESSION");
+
+// All mbedTLS state for one connection (arena, too large for the task stack)
+typedef struct {
+    mbedtls_net_context net;
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config conf;
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_ssl_session offered;
+    bool offered_session;
+} tls_conn_t;
+
+// Working memory of a fetch: connection state and, for a gzip body, the decoder.
+// One heap block per request, freed afterwards, so it is not held between fetches
+static fetch_arena_t s_arena;
+static size_t s_arena_peak = 0;  // Highest arena use since boot
+
+_Static_assert(HW_FETCH_ARENA_SIZE >= sizeof(tls_conn_t) + (HW_GZIP_RESPONSE_ENABLED ? sizeof(gzip_stream_t) : 0) +
+               2 * FETCH_ARENA_ALIGN, "HW_FETCH_ARENA_SIZE too small for the fetch working memory");
+
+// Response header scanner (only the status code, content encoding and validators are kept)
+typedef struct {
+    bool in_body;
+    bool status_done;
+    bool gzip;
+    char line[96];              // Current header line (longer lines are truncated)
+    size_t line_len;
+    https_stream_stats_t *stats;
+} http_header_scan_t;
+
+static void tls_conn_free(tls_conn_t *conn) {
+    mbedtls_ssl_session_free(&conn->offered);
+    mbedtls_ssl_free(&conn->ssl);
+    mbedtls_ssl_config_free(&conn->conf);
+    mbedtls_ctr_drbg_free(&conn->drbg);
+    mbedtls_entropy_free(&conn->entropy);
+    mbedtls_net_free(&conn->net);
+}
+
+static bool session_cached_for(const char *host) {
+#if HW_TLS_SESSION_RESUMPTION_ENABLED
+    return s_session_cache.valid && strncmp(s_session_cache.host, host, sizeof(s_session_cache.host)) == 0;
+#else
+    (void)host;
+    return false;
+#endif
+}
+
+// Check whether the offered session was resumed and cache the negotiated one for the next wake
+static void update_session(const tls_conn_t *conn, const char *host, https_stream_stats_t *stats) {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    if (mbedtls_ssl_get_session(&conn->ssl, &session) != 0) {
+        mbedtls_ssl_session_free(&session);
+        return;
+    }
+
+    // A resumed session keeps the session ID the client offered
+    stats->resumed = conn->offered_session && conn->offered.id_len > 0 &&
+                     session.id_len == conn->offered.id_len &&
+                     memcmp(session.id, conn->offered.id, session.id_len) == 0;
+
+#if HW_TLS_SESSION_RESUMPTION_ENABLED
+    size_t len = 0;
+    if (mbedtls_ssl_session_save(&session, s_session_cache.data, sizeof(s_session_cache.data), &len) == 0) {
+        strncpy(s_session_cache.host, host, sizeof(s_session_cache.host) - 1);
+        s_session_cache.host[sizeof(s_session_cache.host) - 1] = '\0';
+        s_session_cache.len = (uint16_t)len;
+        s_session_cache.valid = true;
+        ESP_LOGD(TAG, "TLS session cached (%u bytes)", (unsigned)len);
+    } else {
+        // Usually the peer certificate is kept in the session (CONFIG_MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+        s_session_cache.valid = false;
+        ESP_LOGW(TAG, "TLS session does not fit the %d byte cache", HW_TLS_SESSION_CACHE_SIZE);
+    }
+#else
+    (void)host;
+#endif
+    mbedtls_ssl_session_free(&session);
+}
+
+// Connect and complete the TLS handshake, offering the cached session if allowed
+static int tls_connect(tls_conn_t *conn, const char *host, int timeout_ms, bool offer_session,
+                       https_stream_stats_t *stats) {
+    mbedtls_net_init(&conn->net);
+    mbedtls_ssl_init(&conn->ssl);
+    mbedtls_ssl_config_init(&conn->conf);
+    mbedtls_entropy_init(&conn->entropy);
+    mbedtls_ctr_drbg_init(&conn->drbg);
+    mbedtls_ssl_session_init(&conn->offered);
+    conn->offered_session = false;
+
+    int ret = mbedtls_ctr_drbg_seed(&conn->drbg, mbedtls_entropy_func, &conn->entropy, NULL, 0);
+    if (ret == 0) {
+        ret = mbedtls_ssl_config_defaults(&conn->conf, MBEDTLS_SSL_IS_CLIENT,
+                                          MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    }
+    if (ret != 0) {
+        return ret;
+    }
+
+    mbedtls_ssl_conf_authmode(&conn->conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_rng(&conn->conf, mbedtls_ctr_drbg_random, &conn->drbg);
+    mbedtls_ssl_conf_read_timeout(&conn->conf, timeout_ms);
+    if (esp_crt_bundle_attach(&conn->conf) != ESP_OK) {
+        return MBEDTLS_ERR_SSL_BAD_CONFIG;
+    }
+
+    if ((ret = mbedtls_ssl_setup(&conn->ssl, &conn->conf)) != 0 ||
+        (ret = mbedtls_ssl_set_hostname(&conn->ssl, host)) != 0) {
+        return ret;
+    }
+
+    if (offer_session && session_cached_for(host) &&
+        mbedtls_ssl_session_load(&conn->offered, s_session_cache.data, s_session_cache.len) == 0 &&
+        mbedtls_ssl_set_session(&conn->ssl, &conn->offered) == 0) {
+        conn->offered_session = true;
+    }
+
+    if ((ret = mbedtls_net_connect(&conn->net, host, "443", MBEDTLS_NET_PROTO_TCP)) != 0) {
+        return ret;
+    }
+    mbedtls_ssl_set_bio(&conn->ssl, &conn->net, mbedtls_net_send, NULL, mbedtls_net_recv_timeout);
+
+    // Certificate verification and key exchange are the CPU-heavy part of the fetch
+    int64_t start_us = esp_timer_get_time();
+    power_profile_compute_begin();
+    do {
+        ret = mbedtls_ssl_handshake(&conn->ssl);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+    power_profile_compute_end();
+    stats->handshake_us = esp_timer_get_time() - start_us;
+    return ret;
+}
+
+// Value of a "Name: value" header line if the name matches (case-insensitive), NULL otherwise
+static const char *header_value(const char *line, const char *name) {
+    size_t name_len = strlen(name);
+    if (strncasecmp(line, name, name_len) != 0 || line[name_len] != ':') {
+        return NULL;
+    }
+    const char *value = line + name_len + 1;
+    while (*value == ' ') {
+        value++;
+    }
+    return value;
+}
+
+// Copy a header value, dropping values that do not fit (a truncated validator is useless)
+static void copy_header_value(char *dst, size_t size, const char *value) {
+    if (strlen(value) < size) {
+        strcpy(dst, value);
+    }
+}
+
+// Handle one complete header line
+static void header_line(http_header_scan_t *scan) {
+    scan->line[scan->line_len] = '\0';
+    const char *value;
+
+    if (!scan->status_done) {
+        scan->status_done = true;
+        if (sscanf(scan->line, "HTTP/%*d.%*d %d", &scan->stats->status_code) != 1) {
+            scan->stats->status_code = 0;
+        }
+    } else if (scan->line_len == 0) {
+        scan->in_body = true;
+    } else if ((value = header_value(scan->line, "Content-Encoding")) != NULL) {
+        scan->gzip = strstr(value, "gzip") != NULL;
+    } else if ((value = header_value(scan->line, "ETag")) != NULL) {
+        copy_header_value(scan->stats->etag, sizeof(scan->stats->etag), value);
+    } else if ((value = header_value(scan->line, "Last-Modified")) != NULL) {
+        copy_header_value(scan->stats->last_modified, sizeof(scan->stats->last_modified), value);
+    }
+    scan->line_len = 0;
+}
+
+// Scan response headers; returns the number of bytes consumed (the rest of the chunk is body)
+static size_t scan_headers(http_header_scan_t *scan, const char *data, size_t len) {
+    size_t i = 0;
+    while (!scan->in_body && i < len) {
+        char c = data[i++];
+        if (c == '\n') {
+            header_line(scan);
+        } else if (c != '\r' && scan->line_len < sizeof(scan->line) - 1) {
+            scan->line[scan->line_len++] = c;
+        }
+    }
+    return i;
+}
+
+// Read/write on the connection, through TLS or on the plain socket
+static int conn_write(tls_conn_t *conn, bool tls, const char *data, size_t len) {
+    return tls ? mbedtls_ssl_write(&conn->ssl, (const unsigned char *)data, len)
+               : mbedtls_net_send(&conn->net, (const unsigned char *)data, len);
+}
+
+static int conn_read(tls_conn_t *conn, bool tls, char *buf, size_t size, int timeout_ms) {
+    return tls ? mbedtls_ssl_read(&conn->ssl, (unsigned char *)buf, size)
+               : mbedtls_net_recv_timeout(&conn->net, (unsigned char *)buf, size, timeout_ms);
+}
+
+static void conn_close(tls_conn_t *conn, bool tls) {
+    if (tls) {
+        mbedtls_ssl_close_notify(&conn->ssl);
+        tls_conn_free(conn);
+    } else {
+        mbedtls_net_free(&conn->net);
+    }
+}
+
+// Allocate the arena for one request; released with arena_close()
+static esp_err_t arena_open(void) {
+    void *buffer = heap_caps_aligned_alloc(FETCH_ARENA_ALIGN, HW_FETCH_ARENA_SIZE, MALLOC_CAP_8BIT);
+    if (!buffer) {
+        ESP_LOGE(TAG, "No memory for the fetch arena (%u bytes)", (unsigned)HW_FETCH_ARENA_SIZE);
+        return ESP_ERR_NO_MEM;
+    }
+    fetch_arena_init(&s_arena, buffer, HW_FETCH_ARENA_SIZE);
+    return ESP_OK;
+}
+
+// Everything a request allocated lived in the arena: record its use and free it in one go
+static void arena_close(https_stream_stats_t *stats) {
+    if (s_arena.peak > s_arena_peak) {
+        s_arena_peak = s_arena.peak;
+    }
+    stats->arena_used = (uint32_t)s_arena.used;
+    stats->arena_peak = (uint32_t)s_arena_peak;
+    ESP_LOGD(TAG, "Fetch arena %u of %u bytes (peak %u)", (unsigned)s_arena.used,
+             (unsigned)s_arena.size, (unsigned)s_arena_peak);
+    heap_caps_free(s_arena.base);
+    fetch_arena_init(&s_arena, NULL, 0);
+}
+
+// Send the GET request on an open connection, stream the response body and
+// close the connection; the arena is freed afterwards
+static esp_err_t exchange(tls_conn_t *conn, bool tls, const char *host_header, const char *path,
+                          const char *extra_headers, int timeout_ms,
+                          https_stream_body_cb_t on_body, void *ctx, https_stream_stats_t *stats) {
+    // HTTP/1.0: no chunked transfer encoding, the body ends when the server closes
+    char request[448];
+    int request_len = snprintf(request, sizeof(request),
+                               "GET %s HTTP/1.0\r\nHost: %s\r\nUser-Agent: esp32\r\nAccept-Encoding: %s\r\n%s\r\n",
+                               path, host_header, HW_GZIP_RESPONSE_ENABLED ? "gzip" : "identity",
+                               extra_headers ? extra_headers : "");
+    esp_err_t err = ESP_OK;
+    if (request_len < 0 || (size_t)request_len >= sizeof(request)) {
+        ESP_LOGE(TAG, "Request too long");
+        err = ESP_ERR_INVALID_SIZE;
+    }
+
+    int ret;
+    for (int written = 0; err == ESP_OK && written < request_len;) {
+        ret = conn_write(conn, tls, request + written, request_len - written);
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            continue;
+        }
+        if (ret < 0) {
+            ESP_LOGE(TAG, "Request write failed: -0x%04x", -ret);
+            err = ESP_FAIL;
+            break;
+        }
+        written += ret;
+    }
+
+    http_header_scan_t scan = {.stats = stats};
+    gzip_stream_t *gzip = NULL;     // Only allocated for a gzip body (dictionary needs 32 KB)
+    char buf[512];
+    while (err == ESP_OK) {
+        ret = conn_read(conn, tls, buf, sizeof(buf), timeout_ms);
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            continue;
+        }
+        if (ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
+            break;
+        }
+        if (ret < 0) {
+            ESP_LOGE(TAG, "Response read failed: -0x%04x", -ret);
+            err = ESP_FAIL;
+            break;
+        }
+
+        size_t header_len = scan.in_body ? 0 : scan_headers(&scan, buf, ret);
+        if (!scan.in_body || header_len == (size_t)ret) {
+            continue;
+        }
+
+        const char *body = buf + header_len;
+        size_t body_len = ret - header_len;
+        stats->body_bytes += body_len;
+        if (!scan.gzip) {
+            if (on_body) {
+                power_profile_compute_begin();
+                on_body(body, body_len, ctx);
+                power_profile_compute_end();
+            }
+            continue;
+        }
+
+        if (!gzip) {
+            gzip = fetch_arena_alloc(&s_arena, sizeof(gzip_stream_t));
+            if (!gzip) {
+                ESP_LOGE(TAG, "Fetch arena too small for the gzip decoder");
+                err = ESP_ERR_NO_MEM;
+                break;
+            }
+            gzip_stream_init(gzip, on_body, ctx);
+        }
+        // Inflating also runs the parser on the inflated output
+        power_profile_compute_begin();
+        bool fed = gzip_stream_feed(gzip, (const uint8_t *)body, body_len);
+        power_profile_compute_end();
+        if (!fed) {
+            ESP_LOGE(TAG, "Corrupt gzip body");
+            err = ESP_FAIL;
+        }
+    }
+
+    if (err == ESP_OK) {
+        stats->gzip = scan.gzip;
+        if (stats->status_code == 0 || !scan.in_body) {
+            ESP_LOGE(TAG, "Malformed HTTP response");
+            err = ESP_FAIL;
+        } else if (gzip) {
+            power_profile_compute_begin();
+            gzip_stream_result_t finished = gzip_stream_finish(gzip);
+            power_profile_compute_end();
+            if (finished != GZIP_STREAM_OK) {
+                ESP_LOGE(TAG, "Incomplete gzip body");
+                err = ESP_FAIL;
+            }
+            ESP_LOGI(TAG, "Body %lu bytes gzip, %lu bytes inflated",
+                     (unsigned long)stats->body_bytes, (unsigned long)gzip->total_out);
+        } else {
+            ESP_LOGI(TAG, "Body %lu bytes", (unsigned long)stats->body_bytes);
+        }
+    }
+
+    conn_close(conn, tls);
+    arena_close(stats);
+    return err;
+}
+
+// Reset the stats for a new request
+static https_stream_stats_t *begin_request(https_stream_stats_t *stats, https_stream_stats_t *local_stats) {
+    if (!stats) {
+        stats = local_stats;
+    }
+    memset(stats, 0, sizeof(*stats));
+    return stats;
+}
+
+esp_err_t https_stream_get(const char *host, const char *path, const char *extra_headers, int timeout_ms,
+                           https_stream_body_cb_t on_body, void *ctx, https_stream_stats_t *stats) {
+    https_stream_stats_t local_stats;
+    stats = begin_request(stats, &local_stats);
+
+    if (arena_open() != ESP_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+    tls_conn_t *conn = fetch_arena_alloc(&s_arena, sizeof(tls_conn_t));
+    if (!conn) {
+        ESP_LOGE(TAG, "Fetch arena too small for the TLS connection");
+        arena_close(stats);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Offer the cached session; if that handshake fails, retry once with a full handshake
+    bool offer_session = session_cached_for(host);
+    int ret = tls_connect(conn, host, timeout_ms, offer_session, stats);
+    if (ret != 0 && offer_session) {
+        ESP_LOGW(TAG, "Handshake with cached session failed (-0x%04x), retrying with full handshake", -ret);
+        tls_conn_free(conn);
+        https_stream_forget_session();
+        ret = tls_connect(conn, host, timeout_ms, false, stats);
+    }
+    if (ret != 0) {
+        ESP_LOGE(TAG, "TLS connection to %s failed: -0x%04x", host, -ret);
+        tls_conn_free(conn);
+        arena_close(stats);
+        return ESP_FAIL;
+    }
+
+    update_session(conn, host, stats);
+    ESP_LOGI(TAG, "TLS handshake %lld ms (%s)", stats->handshake_us / 1000,
+             stats->resumed ? "resumed" : (conn->offered_session ? "full, session refused" : "full"));
+
+    return exchange(conn, true, host, path, extra_headers, timeout_ms, on_body, ctx, stats);
+}
+
+esp_err_t http_stream_get(const char *url, const char *extra_headers, int timeout_ms,
+                          https_stream_body_cb_t on_body, void *ctx, https_stream_stats_t *stats) {
+    https_stream_stats_t local_stats;
+    stats = begin_request(stats, &local_stats);
+
+    // "http://host[:port]/path"
+    char host[64];
+    char port[6] = "80";
+    const char *authority = (strncmp(url, "http://", 7) == 0) ? url + 7 : NULL;
+    const char *path = authority ? strchr(authority, '/') : NULL;
+    size_t authority_len = path ? (size_t)(path - authority) : 0;
+    if (!path || authority_len == 0 || authority_len >= sizeof(host)) {
+        ESP_LOGE(TAG, "Unsupported URL: %s", url);
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(host, authority, authority_len);
+    host[authority_len] = '\0';
+
+    char host_name[sizeof(host)];
+    strcpy(host_name, host);
+    char *colon = strchr(host_name, ':');
+    if (colon) {
+        *colon = '\0';
+        if (strlen(colon + 1) == 0 || strlen(colon + 1) >= sizeof(port)) {
+            ESP_LOGE(TAG, "Unsupported URL: %s", url);
+            return ESP_ERR_INVALID_ARG;
+        }
+        strcpy(port, colon + 1);
+    }
+
+    if (arena_open() != ESP_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+    tls_conn_t *conn = fetch_arena_alloc(&s_arena, sizeof(tls_conn_t));
+    if (!conn) {
+        ESP_LOGE(TAG, "Fetch arena too small for the connection");
+        arena_close(stats);
+        return ESP_ERR_NO_MEM;
+    }
+    mbedtls_net_init(&conn->net);
+    int ret = mbedtls_net_connect(&conn->net, host_name, port, MBEDTLS_NET_PROTO_TCP);
+    if (ret != 0) {
+        ESP_LOGE(TAG, "Connection to %s:%s failed: -0x%04x", host_name, port, -ret);
+        mbedtls_net_free(&conn->net);
+        arena_close(stats);
+        return ESP_FAIL;
+    }
+
+    return exchange(conn, false, host, path, extra_headers, timeout_ms, on_body, ctx, stats);
+}
+
+void https_stream_forget_session(void) {
+    s_session_cache.valid = false;
+}
@@ -34,4 +34,15 @@ int led_count_from_cloudcover(float cloudcover);
  */
 void control_leds(const gpio_num_t *led_pins, int num_leds, bool mainPinActive, float cloudcover);
 
+/**
+ * @brief Light a given number of LEDs (e.g. the log server's decision)
+ *
+ * LEDs use active-low logic (0=ON, 1=OFF).
+ *
+ * @param led_pins Array of GPIO pin numbers for LEDs
+ * @param num_leds Number of LEDs in the array
+ * @param active_leds Number of LEDs to turn on, from the first pin (the rest are turned off)
+ */
+void control_led_count(const gpio_num_t *led_pins, int num_leds, int active_leds);
+
 #endif // CLOUDCOVER_LEDS_H
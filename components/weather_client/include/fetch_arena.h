@@ -0,0 +1,54 @@
+#ifndef FETCH_ARENA_H
+#define FETCH_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file fetch_arena.h
+ * @brief Bump allocator for the working memory of one forecast fetch
+ *
+ * Allocation moves a pointer forward in a caller-supplied buffer; nothing is freed
+ * individually, the whole arena is released with one reset when the fetch is
+ * done. Allocation cost is constant and the large blocks a fetch needs (TLS
+ * connection state, gzip dictionary) never depend on how fragmented the heap is.
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+// Alignment of every allocation
+#define FETCH_ARENA_ALIGN 8
+
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;                    // Bytes allocated since the last reset
+    size_t peak;                    // Highest use since init
+} fetch_arena_t;
+
+/**
+ * @brief Set up an arena on a buffer
+ *
+ * @param arena Arena
+ * @param buffer Backing buffer (FETCH_ARENA_ALIGN aligned)
+ * @param size Buffer size in bytes
+ */
+void fetch_arena_init(fetch_arena_t *arena, void *buffer, size_t size);
+
+/**
+ * @brief Allocate zeroed memory from the arena
+ *
+ * @param arena Arena
+ * @param size Bytes to allocate
+ * @return Pointer, or NULL if the arena is full
+ */
+void *fetch_arena_alloc(fetch_arena_t *arena, size_t size);
+
+/**
+ * @brief Release everything allocated since the last reset
+ *
+ * @param arena Arena
+ */
+void fetch_arena_reset(fetch_arena_t *arena);
+
+#endif // FETCH_ARENA_H
@@ -0,0 +1,80 @@
+#ifndef FORECAST_CACHE_H
+#define FORECAST_CACHE_H
+
+#include "forecast_values.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file forecast_cache.h
+ * @brief Compact multi-day forecast cache (kept in RTC memory by the caller)
+ *
+ * Holds the days of the last successful forecast response in the compact
+ * forecast_day_t form (~40 bytes per day), the time it was fetched and the
+ * HTTP validators (ETag, Last-Modified) for a conditional request. A CRC over
+ * the contents detects a cache that was never written or got corrupted (RTC
+ * memory survives deep sleep and software resets but not power loss).
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+// Days the cache can hold
+#define FORECAST_CACHE_DAYS 7
+
+typedef struct {
+    uint32_t crc;                   // CRC-32 of everything after this field
+    int64_t fetched_at;             // UTC epoch of the last response (200 or 304)
+    uint32_t query_hash;            // CRC-32 of the request path the validators belong to
+    char etag[48];                  // ETag of the last response ("" = none)
+    char last_modified[32];         // Last-Modified of the last response ("" = none)
+    uint8_t num_days;
+    forecast_day_t days[FORECAST_CACHE_DAYS];
+} forecast_cache_t;
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of a buffer
+ */
+uint32_t forecast_cache_crc32(const void *data, size_t len);
+
+/**
+ * @brief Check the cache CRC
+ *
+ * @return true if the cache holds data written by forecast_cache_store()
+ */
+bool forecast_cache_valid(const forecast_cache_t *cache);
+
+/**
+ * @brief Replace the cached days with those of a parsed response
+ *
+ * Days before from_date are skipped; at most FORECAST_CACHE_DAYS are kept.
+ *
+ * @param cache Cache
+ * @param values Parsed response
+ * @param from_date First date to keep ("YYYY-MM-DD", NULL = all)
+ * @param fetched_at UTC epoch of the response
+ * @param query_hash forecast_cache_crc32() of the request path
+ * @param etag ETag response header (NULL or "" = none)
+ * @param last_modified Last-Modified response header (NULL or "" = none)
+ */
+void forecast_cache_store(forecast_cache_t *cache, const forecast_values_t *values, const char *from_date,
+                          int64_t fetched_at, uint32_t query_hash, const char *etag, const char *last_modified);
+
+/**
+ * @brief Mark the cached days as confirmed by the server (304 Not Modified)
+ *
+ * @param cache Cache
+ * @param fetched_at UTC epoch of the response
+ */
+void forecast_cache_touch(forecast_cache_t *cache, int64_t fetched_at);
+
+/**
+ * @brief Find a day in the cache
+ *
+ * @param cache Cache (must be valid)
+ * @param date "YYYY-MM-DD"
+ * @return Day, or NULL if not cached
+ */
+const forecast_day_t *forecast_cache_find(const forecast_cache_t *cache, const char *date);
+
+#endif // FORECAST_CACHE_H
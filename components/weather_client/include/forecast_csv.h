@@ -0,0 +1,79 @@
+#ifndef FORECAST_CSV_H
+#define FORECAST_CSV_H
+
+#include "forecast_values.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file forecast_csv.h
+ * @brief Streaming parser for the Open-Meteo forecast response (format=csv)
+ *
+ * The CSV response is a series of blocks separated by empty lines: location
+ * metadata (only utc_offset_seconds is kept), then one block per requested
+ * group with a "time,..." header row:
+ *
+ *     latitude,longitude,elevation,utc_offset_seconds,timezone,...
+ *     52.24,21.02,113.0,7200,Europe/Warsaw,CEST
+ *
+ *     time,cloudcover (%)
+ *     2025-10-20T00:00,68
+ *
+ *     time,sunrise (iso8601),sunset (iso8601)
+ *     2025-10-20,2025-10-20T07:10,2025-10-20T17:30
+ *
+ * Columns are located by their header, so block and column order do not
+ * matter. Fed in chunks of any size; only the current line is kept. Rows
+ * carry no structure to check, so a truncated body shows up as missing data.
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+// Longest line kept; longer lines (location metadata) are truncated
+#define FORECAST_CSV_LINE_SIZE 64
+
+typedef struct {
+    char line[FORECAST_CSV_LINE_SIZE];
+    uint8_t line_len;
+    uint8_t block;                  // Block type of the current block
+    int8_t cloudcover_column;       // Column indexes from the block header (-1 = absent)
+    int8_t sunrise_column;
+    int8_t sunset_column;
+    int8_t utc_offset_column;       // Column of utc_offset_seconds in the location block (-1 = absent)
+    uint16_t row;                   // Data row within the current block
+
+    // Values collected on the fly
+    forecast_values_t values;
+} forecast_csv_parser_t;
+
+/**
+ * @brief Reset the parser for a new response
+ *
+ * @param parser Parser state
+ * @param target_date "YYYY-MM-DD" the request was limited to, or NULL (see forecast_values.h)
+ */
+void forecast_csv_init(forecast_csv_parser_t *parser, const char *target_date);
+
+/**
+ * @brief Feed the next chunk of the response body
+ *
+ * @param parser Parser state
+ * @param data Chunk data
+ * @param len Chunk length in bytes
+ * @return Always true (CSV rows cannot be malformed in a way that matters)
+ */
+bool forecast_csv_feed(forecast_csv_parser_t *parser, const char *data, size_t len);
+
+/**
+ * @brief Finish parsing and compute tomorrow's daytime cloud cover
+ *
+ * See forecast_values_finish(). weather_data->valid is set on success.
+ *
+ * @param parser Parser state
+ * @param weather_data Result (all fields are written)
+ * @return FORECAST_PARSE_OK or FORECAST_PARSE_ERR_NO_DATA
+ */
+forecast_parse_result_t forecast_csv_finish(forecast_csv_parser_t *parser, weather_data_t *weather_data);
+
+#endif // FORECAST_CSV_H
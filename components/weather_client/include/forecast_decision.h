@@ -0,0 +1,62 @@
+#ifndef FORECAST_DECISION_H
+#define FORECAST_DECISION_H
+
+#include "forecast_values.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file forecast_decision.h
+ * @brief Decoder for the log server's compact forecast decision record
+ *
+ * The log server (GET /api/decision) averages tomorrow's daytime cloud cover
+ * and maps it to the pin-off hour and LED count (HW_CLOUDCOVER_RANGES) itself,
+ * then sends the result as one fixed 32-byte record instead of a forecast to
+ * parse. All multi-byte fields are little-endian:
+ *
+ *   offset  size  field
+ *        0     1  version (FORECAST_DECISION_VERSION)
+ *        1     1  pin_off_hour (0-23)
+ *        2     2  date, days since 2000-01-01
+ *        4     1  led_count
+ *        5     1  average daytime cloud cover in 0.5 % steps (0-200)
+ *        6    24  cloud cover by local hour in percent (0xFF = unknown)
+ *       30     2  CRC-16/CCITT-FALSE of bytes 0-29
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+#define FORECAST_DECISION_SIZE 32
+#define FORECAST_DECISION_VERSION 1
+
+typedef enum {
+    FORECAST_DECISION_OK = 0,
+    FORECAST_DECISION_ERR_SIZE,     // Not exactly FORECAST_DECISION_SIZE bytes
+    FORECAST_DECISION_ERR_CRC,      // Corrupt record
+    FORECAST_DECISION_ERR_VERSION,  // Record version not supported
+    FORECAST_DECISION_ERR_RANGE,    // Field out of range
+} forecast_decision_result_t;
+
+typedef struct {
+    forecast_day_t day;             // Date and hourly cloud cover (sunrise/sunset unknown)
+    int pin_off_hour;
+    int led_count;
+    float avg_cloudcover;
+} forecast_decision_t;
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+ */
+uint16_t forecast_decision_crc16(const uint8_t *data, size_t len);
+
+/**
+ * @brief Decode a decision record
+ *
+ * @param data Record bytes
+ * @param len Number of bytes received
+ * @param decision Decoded record (only valid on FORECAST_DECISION_OK)
+ * @return FORECAST_DECISION_OK or the reason the record was rejected
+ */
+forecast_decision_result_t forecast_decision_decode(const uint8_t *data, size_t len, forecast_decision_t *decision);
+
+#endif // FORECAST_DECISION_H
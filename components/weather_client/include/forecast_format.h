@@ -0,0 +1,81 @@
+#ifndef FORECAST_FORMAT_H
+#define FORECAST_FORMAT_H
+
+#include "forecast_csv.h"
+#include "forecast_parser.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file forecast_format.h
+ * @brief Response format abstraction for the forecast request
+ *
+ * Open-Meteo returns JSON by default and CSV with format=csv. Each format has
+ * its own streaming parser behind the same decoder interface, so the fetch
+ * code does not depend on the format it requested. CSV carries the same
+ * values without key names and quoting: fewer bytes to receive and less
+ * tokenizer work per value.
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+typedef enum {
+    FORECAST_FORMAT_JSON = 0,
+    FORECAST_FORMAT_CSV,
+} forecast_format_t;
+
+typedef struct {
+    forecast_format_t format;
+    union {
+        forecast_parser_t json;
+        forecast_csv_parser_t csv;
+    } parser;
+} forecast_decoder_t;
+
+/**
+ * @brief Value of the format= query parameter
+ *
+ * @param format Response format
+ * @return Parameter value, or NULL for the default format (JSON)
+ */
+const char *forecast_format_query_value(forecast_format_t format);
+
+/**
+ * @brief Format name for logs
+ */
+const char *forecast_format_name(forecast_format_t format);
+
+/**
+ * @brief Reset the decoder for a new response in the given format
+ *
+ * @param decoder Decoder state
+ * @param format Format the request asked for
+ * @param target_date "YYYY-MM-DD" the request was limited to, or NULL (see forecast_values.h)
+ */
+void forecast_decoder_init(forecast_decoder_t *decoder, forecast_format_t format, const char *target_date);
+
+/**
+ * @brief Feed the next chunk of the response body
+ *
+ * @return false once the response is known to be malformed
+ */
+bool forecast_decoder_feed(forecast_decoder_t *decoder, const char *data, size_t len);
+
+/**
+ * @brief Finish parsing and compute tomorrow's daytime cloud cover
+ *
+ * @param decoder Decoder state
+ * @param weather_data Result (all fields are written)
+ * @return FORECAST_PARSE_OK or the reason the result is not valid
+ */
+forecast_parse_result_t forecast_decoder_finish(forecast_decoder_t *decoder, weather_data_t *weather_data);
+
+/**
+ * @brief Values collected so far (daytime window after forecast_decoder_finish)
+ *
+ * Days can be completed before forecast_decoder_finish(), e.g. with sunrise and
+ * sunset the response did not include.
+ */
+forecast_values_t *forecast_decoder_values(forecast_decoder_t *decoder);
+
+#endif // FORECAST_FORMAT_H
@@ -0,0 +1,82 @@
+#ifndef FORECAST_PARSER_H
+#define FORECAST_PARSER_H
+
+#include "forecast_values.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file forecast_parser.h
+ * @brief Streaming parser for the Open-Meteo forecast response (JSON)
+ *
+ * Fed with the response body in chunks of any size as they arrive (e.g., from
+ * HTTP_EVENT_ON_DATA), so the body never has to be buffered. A small JSON
+ * tokenizer tracks the path of each value and keeps only what is needed:
+ * hourly.time / hourly.cloudcover entries, daily time, sunrise and sunset, and
+ * the top-level utc_offset_seconds, which go to forecast_values. Everything else is skipped. The parser state is
+ * a fixed-size struct and nothing is allocated, whatever the size of the response.
+ *
+ * Pure logic with no ESP-IDF dependencies (builds and benchmarks on the host,
+ * see tools/forecast_bench).
+ */
+
+// Deepest JSON nesting accepted (the forecast response uses 3)
+#define FORECAST_PARSER_MAX_DEPTH 8
+
+// Longest string or number kept; longer tokens are truncated (timestamps use 16)
+#define FORECAST_PARSER_TOKEN_SIZE 24
+
+typedef struct {
+    uint8_t is_array;
+    uint8_t key;                    // Key of the current member (objects)
+    uint16_t index;                 // Index of the current element (arrays)
+} forecast_parser_level_t;
+
+typedef struct {
+    // Tokenizer state
+    uint8_t lex_state;
+    uint8_t expect;
+    bool error;
+    bool token_is_key;
+    uint8_t token_len;
+    char token[FORECAST_PARSER_TOKEN_SIZE];
+    uint8_t depth;
+    forecast_parser_level_t stack[FORECAST_PARSER_MAX_DEPTH];
+
+    // Values collected on the fly
+    forecast_values_t values;
+} forecast_parser_t;
+
+/**
+ * @brief Reset the parser for a new response
+ *
+ * @param parser Parser state
+ * @param target_date "YYYY-MM-DD" the request was limited to, or NULL (see forecast_values.h)
+ */
+void forecast_parser_init(forecast_parser_t *parser, const char *target_date);
+
+/**
+ * @brief Feed the next chunk of the response body
+ *
+ * Chunks may split tokens anywhere. After a syntax error further input is ignored.
+ *
+ * @param parser Parser state
+ * @param data Chunk data
+ * @param len Chunk length in bytes
+ * @return false once a syntax error has been found
+ */
+bool forecast_parser_feed(forecast_parser_t *parser, const char *data, size_t len);
+
+/**
+ * @brief Finish parsing and compute tomorrow's daytime cloud cover
+ *
+ * See forecast_values_finish(). weather_data->valid is set on success.
+ *
+ * @param parser Parser state
+ * @param weather_data Result (all fields are written)
+ * @return FORECAST_PARSE_OK or the reason the result is not valid
+ */
+forecast_parse_result_t forecast_parser_finish(forecast_parser_t *parser, weather_data_t *weather_data);
+
+#endif // FORECAST_PARSER_H
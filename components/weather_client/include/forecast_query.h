@@ -0,0 +1,50 @@
+#ifndef FORECAST_QUERY_H
+#define FORECAST_QUERY_H
+
+#include "forecast_format.h"
+#include <stddef.h>
+
+/**
+ * @file forecast_query.h
+ * @brief Open-Meteo forecast request builder
+ *
+ * The request covers today and `days` days from tomorrow (forecast_days). It
+ * carries no dates, so the path is the same every day and a cached response's
+ * validators still belong to it (If-None-Match / If-Modified-Since); the
+ * parsers skip today by the target date, or take the second day without one
+ * (clock not set). Only hourly cloud cover is requested; sunrise and sunset are
+ * computed on the device (solar_position.h).
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+typedef struct {
+    float latitude;
+    float longitude;
+    const char *date;               // "YYYY-MM-DD" of tomorrow for the parsers, or NULL (not sent)
+    int days;                       // Days to request from tomorrow (at least 1)
+    forecast_format_t format;
+} forecast_query_t;
+
+/**
+ * @brief Build the request path including the query string
+ *
+ * @param query Request parameters
+ * @param buf Output buffer
+ * @param size Size of the output buffer
+ * @return Length of the path (>= size if it was truncated)
+ */
+int forecast_query_build(const forecast_query_t *query, char *buf, size_t size);
+
+/**
+ * @brief Format the day after the given date as "YYYY-MM-DD"
+ *
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day of month (1-31)
+ * @param buf Output buffer (at least 11 bytes)
+ * @param size Size of the output buffer
+ */
+void forecast_query_next_date(int year, int month, int day, char *buf, size_t size);
+
+#endif // FORECAST_QUERY_H
@@ -0,0 +1,142 @@
+#ifndef FORECAST_VALUES_H
+#define FORECAST_VALUES_H
+
+#include "weather_data.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file forecast_values.h
+ * @brief Forecast values collected by the response parsers
+ *
+ * Every response format (see forecast_format.h) reports the hourly and daily
+ * entries it finds here. They are kept per calendar day in compact form
+ * (forecast_day_t: cloud cover as whole percent, sunrise/sunset as minutes),
+ * which is also what the RTC forecast cache stores. forecast_day_summarize()
+ * then computes a day's daytime cloud cover the same way for every source.
+ *
+ * The response's utc_offset_seconds is kept too: the hourly times are local
+ * times at that single offset, so sun times computed on the device have to use
+ * it to line up with the hours (the device's own time zone may differ).
+ *
+ * "Tomorrow" is the target date if one is given (the request started at that
+ * day), otherwise the first hourly date after the first one in the response
+ * (request for today and tomorrow).
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+// Days kept from one response (today and FORECAST_CACHE_DAYS days from tomorrow)
+#define FORECAST_MAX_DAYS 8
+
+// Hourly entries kept; later entries are ignored
+#define FORECAST_MAX_HOURS (FORECAST_MAX_DAYS * 24)
+
+// Cloud cover of an hour without a value
+#define FORECAST_CLOUDCOVER_UNKNOWN 0xFF
+
+typedef enum {
+    FORECAST_PARSE_OK = 0,
+    FORECAST_PARSE_ERR_SYNTAX,      // Malformed response
+    FORECAST_PARSE_ERR_INCOMPLETE,  // Body ended before the document did
+    FORECAST_PARSE_ERR_NO_DATA,     // Valid response without daytime cloud cover for tomorrow
+} forecast_parse_result_t;
+
+// One calendar day of forecast in compact form
+typedef struct {
+    char date[11];                  // "YYYY-MM-DD"
+    uint8_t cloudcover[24];         // Percent by local hour, FORECAST_CLOUDCOVER_UNKNOWN if missing
+    int16_t sunrise_minutes;        // Minutes after midnight, -1 if unknown
+    int16_t sunset_minutes;
+} forecast_day_t;
+
+typedef struct {
+    char target_date[11];           // Requested first date ("" = next date in the response)
+    char first_date[11];            // Date of the first hourly entry
+    bool has_utc_offset;            // utc_offset_seconds was in the response
+    int32_t utc_offset_seconds;     // Offset of the hourly times from UTC
+    int8_t hour_slot[FORECAST_MAX_HOURS];       // Day slot of each hourly entry (-1 = not kept)
+    int8_t hour_of_day[FORECAST_MAX_HOURS];
+    int8_t daily_slot[FORECAST_MAX_DAYS];       // Day slot of each daily entry (-1 = not kept)
+    forecast_day_t days[FORECAST_MAX_DAYS];     // In order of first appearance
+    uint8_t num_days;
+
+    // Daytime window used for the average (set by forecast_values_finish)
+    int window_start_hour;
+    int window_end_hour;
+} forecast_values_t;
+
+/**
+ * @brief Reset the values for a new response
+ *
+ * @param values Values
+ * @param target_date "YYYY-MM-DD" the request started at (tomorrow), or NULL
+ */
+void forecast_values_init(forecast_values_t *values, const char *target_date);
+
+/**
+ * @brief Hourly entry timestamp ("2025-10-20T06:00"); must come before its cloud cover
+ */
+void forecast_values_hour_time(forecast_values_t *values, int index, const char *timestamp, size_t len);
+
+/**
+ * @brief Hourly entry cloud cover in percent
+ */
+void forecast_values_hour_cloudcover(forecast_values_t *values, int index, float cloudcover);
+
+/**
+ * @brief Response utc_offset_seconds (offset of every time in the response from UTC)
+ */
+void forecast_values_utc_offset(forecast_values_t *values, int32_t seconds);
+
+/**
+ * @brief Daily entry date ("2025-10-20"); must come before the entry's sunrise/sunset
+ */
+void forecast_values_day_time(forecast_values_t *values, int index, const char *date, size_t len);
+
+/**
+ * @brief Daily entry sunrise ("2025-10-20T07:10")
+ */
+void forecast_values_day_sunrise(forecast_values_t *values, int index, const char *timestamp, size_t len);
+
+/**
+ * @brief Daily entry sunset ("2025-10-20T17:30")
+ */
+void forecast_values_day_sunset(forecast_values_t *values, int index, const char *timestamp, size_t len);
+
+/**
+ * @brief Tomorrow's entry in the collected days
+ *
+ * @return Day, or NULL if the response did not contain tomorrow
+ */
+const forecast_day_t *forecast_values_tomorrow(const forecast_values_t *values);
+
+/**
+ * @brief Compute tomorrow's daytime cloud cover
+ *
+ * See forecast_day_summarize(). weather_data->valid is set on success.
+ *
+ * @param values Values
+ * @param weather_data Result (all fields are written)
+ * @return FORECAST_PARSE_OK or FORECAST_PARSE_ERR_NO_DATA
+ */
+forecast_parse_result_t forecast_values_finish(forecast_values_t *values, weather_data_t *weather_data);
+
+/**
+ * @brief Compute a day's daytime cloud cover
+ *
+ * The daytime window starts at sunrise rounded up to the next full hour (plus
+ * one hour if sunrise is at :30 or later) and ends the hour before sunset;
+ * 6-18 if sunrise/sunset are missing. weather_data->valid is set on success.
+ *
+ * @param day Day (NULL = no data)
+ * @param weather_data Result (all fields are written)
+ * @param window_start_hour Set to the first hour of the window (may be NULL)
+ * @param window_end_hour Set to the last hour of the window (may be NULL)
+ * @return FORECAST_PARSE_OK or FORECAST_PARSE_ERR_NO_DATA
+ */
+forecast_parse_result_t forecast_day_summarize(const forecast_day_t *day, weather_data_t *weather_data,
+                                               int *window_start_hour, int *window_end_hour);
+
+#endif // FORECAST_VALUES_H
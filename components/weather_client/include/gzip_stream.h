@@ -0,0 +1,92 @@
+#ifndef GZIP_STREAM_H
+#define GZIP_STREAM_H
+
+#include "miniz.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file gzip_stream.h
+ * @brief Streaming gzip decoder (Content-Encoding: gzip)
+ *
+ * Fed with the compressed body in chunks of any size as they arrive and passes
+ * the inflated data on as it is produced, so neither the compressed nor the
+ * inflated body is ever buffered. The gzip header is parsed here; the deflate
+ * stream is inflated with tinfl (in ROM on the ESP32-S3) into the 32 KB
+ * dictionary ring buffer that deflate back-references require.
+ *
+ * The 8-byte gzip trailer (CRC-32 and size) is not checked: the final deflate
+ * block marks the end of the stream and TLS already guarantees integrity.
+ *
+ * Pure logic with no ESP-IDF dependencies besides miniz (builds on the host
+ * with the miniz library, see tools/gzip_stream_test). The state is about
+ * 43 KB, allocate it on the heap.
+ */
+
+typedef enum {
+    GZIP_STREAM_OK = 0,
+    GZIP_STREAM_ERR_FORMAT,         // Not gzip or corrupt deflate data
+    GZIP_STREAM_ERR_INCOMPLETE,     // Input ended before the final deflate block
+} gzip_stream_result_t;
+
+/**
+ * @brief Called for each piece of inflated data
+ *
+ * @param data Inflated data
+ * @param len Length in bytes
+ * @param ctx User context passed to gzip_stream_init()
+ */
+typedef void (*gzip_stream_output_cb_t)(const char *data, size_t len, void *ctx);
+
+typedef struct {
+    // gzip header parser
+    uint8_t header_state;
+    uint8_t flags;                  // FLG byte of the header
+    uint16_t count;                 // Bytes left in the current header field
+    uint8_t extra_len_low;          // FEXTRA length, low byte
+
+    // Deflate stream
+    tinfl_decompressor inflator;
+    uint8_t dict[TINFL_LZ_DICT_SIZE];
+    size_t dict_offset;
+    bool error;
+
+    uint32_t total_in;              // Compressed bytes fed
+    uint32_t total_out;             // Inflated bytes produced
+
+    gzip_stream_output_cb_t on_output;
+    void *ctx;
+} gzip_stream_t;
+
+/**
+ * @brief Reset the decoder for a new stream
+ *
+ * @param stream Decoder state
+ * @param on_output Output callback
+ * @param ctx User context for on_output
+ */
+void gzip_stream_init(gzip_stream_t *stream, gzip_stream_output_cb_t on_output, void *ctx);
+
+/**
+ * @brief Feed the next chunk of the compressed body
+ *
+ * Chunks may split the header or the deflate data anywhere. After an error
+ * further input is ignored; data after the final deflate block is ignored.
+ *
+ * @param stream Decoder state
+ * @param data Chunk data
+ * @param len Chunk length in bytes
+ * @return false once an error has been found
+ */
+bool gzip_stream_feed(gzip_stream_t *stream, const uint8_t *data, size_t len);
+
+/**
+ * @brief Check that the whole stream has been decoded
+ *
+ * @param stream Decoder state
+ * @return GZIP_STREAM_OK or the reason the stream is not complete
+ */
+gzip_stream_result_t gzip_stream_finish(const gzip_stream_t *stream);
+
+#endif // GZIP_STREAM_H
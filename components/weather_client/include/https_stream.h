@@ -0,0 +1,95 @@
+#ifndef HTTPS_STREAM_H
+#define HTTPS_STREAM_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file https_stream.h
+ * @brief Minimal HTTPS GET with TLS session resumption across deep sleep
+ *
+ * Sends an HTTP/1.0 GET over mbedTLS (certificate bundle verification) and
+ * streams the response body to a callback without buffering it. With
+ * HW_GZIP_RESPONSE_ENABLED the request accepts gzip and a compressed body is
+ * inflated chunk by chunk (gzip_stream) before it reaches the callback.
+ *
+ * The connection state and the gzip decoder are taken from a bump arena
+ * (fetch_arena, HW_FETCH_ARENA_SIZE) that is allocated as one heap block per
+ * request and freed afterwards, so a fetch makes a single allocation of its own
+ * and holds no memory between fetches (mbedTLS still allocates its record
+ * buffers and certificate parsing internally). If the block cannot be
+ * allocated or is too small, the request fails with ESP_ERR_NO_MEM.
+ *
+ * With HW_TLS_SESSION_RESUMPTION_ENABLED, the TLS session (session ticket or
+ * session ID) of the last successful connection is serialized into RTC memory.
+ * The next connection to the same host offers it and the server can resume it
+ * with an abbreviated handshake: no certificate chain, no certificate
+ * verification, no key exchange. If resumption is refused the server simply
+ * does a full handshake; if the handshake fails with a cached session, the
+ * cache is dropped and the connection is retried once with a full handshake.
+ *
+ * http_stream_get() does the same request over plain TCP (no TLS), for
+ * servers on the local network such as the log server's forecast proxy.
+ */
+
+typedef struct {
+    int status_code;            // HTTP status code (0 if no response)
+    bool resumed;               // TLS session was resumed
+    int64_t handshake_us;       // Duration of the TLS handshake
+    bool gzip;                  // Body was gzip-compressed (passed on inflated)
+    uint32_t body_bytes;        // Body bytes received (compressed size for gzip)
+    uint32_t arena_used;        // Fetch arena bytes used by this request
+    uint32_t arena_peak;        // Highest fetch arena use since boot
+    char etag[48];              // ETag response header ("" = none or too long)
+    char last_modified[32];     // Last-Modified response header ("" = none or too long)
+} https_stream_stats_t;
+
+/**
+ * @brief Called for each chunk of the response body
+ *
+ * @param data Chunk data
+ * @param len Chunk length in bytes
+ * @param ctx User context passed to https_stream_get()
+ */
+typedef void (*https_stream_body_cb_t)(const char *data, size_t len, void *ctx);
+
+/**
+ * @brief Fetch https://host/path and stream the body
+ *
+ * @param host Server host name (certificate is verified against it)
+ * @param path Request path including the query string
+ * @param extra_headers Additional request header lines, each ending in "\r\n" (may be NULL)
+ * @param timeout_ms Connect and read timeout
+ * @param on_body Body callback (called only for the body, not the headers; always inflated)
+ * @param ctx User context for on_body
+ * @param stats Filled with status code and handshake details (may be NULL)
+ * @return ESP_OK if a response was received (check stats->status_code), error code otherwise
+ */
+esp_err_t https_stream_get(const char *host, const char *path, const char *extra_headers, int timeout_ms,
+                           https_stream_body_cb_t on_body, void *ctx, https_stream_stats_t *stats);
+
+/**
+ * @brief Fetch a plain http:// URL and stream the body (no TLS)
+ *
+ * Same request, header handling, gzip support and arena use as
+ * https_stream_get(); stats->handshake_us stays 0.
+ *
+ * @param url "http://host[:port]/path?query"
+ * @param extra_headers Additional request header lines, each ending in "\r\n" (may be NULL)
+ * @param timeout_ms Read timeout
+ * @param on_body Body callback (called only for the body, not the headers; always inflated)
+ * @param ctx User context for on_body
+ * @param stats Filled with status code and response details (may be NULL)
+ * @return ESP_OK if a response was received (check stats->status_code), error code otherwise
+ */
+esp_err_t http_stream_get(const char *url, const char *extra_headers, int timeout_ms,
+                          https_stream_body_cb_t on_body, void *ctx, https_stream_stats_t *stats);
+
+/**
+ * @brief Drop the cached TLS session so the next connection does a full handshake
+ */
+void https_stream_forget_session(void);
+
+#endif // HTTPS_STREAM_H
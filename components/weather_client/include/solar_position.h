@@ -0,0 +1,42 @@
+#ifndef SOLAR_POSITION_H
+#define SOLAR_POSITION_H
+
+/**
+ * @file solar_position.h
+ * @brief Sunrise and sunset from latitude, longitude and date (NOAA algorithm)
+ *
+ * Implements the equations of the NOAA Solar Calculator: sun declination and
+ * equation of time from the mean orbital elements, sunrise/sunset when the
+ * center of the sun is 0.833 degrees below the horizon (refraction and the
+ * solar radius). Like the NOAA calculator, the event time is computed at solar
+ * noon and refined once at the estimated event time. Single precision (the
+ * ESP32-S3 FPU has no double support); the result is within a minute of the
+ * double precision computation for latitudes up to 65 degrees (see
+ * tools/solar_check). Elevation and local horizon are not taken into account.
+ *
+ * Pure logic with no ESP-IDF dependencies.
+ */
+
+typedef enum {
+    SOLAR_OK = 0,
+    SOLAR_ALWAYS_UP,                // Polar day: the sun does not set
+    SOLAR_ALWAYS_DOWN,              // Polar night: the sun does not rise
+} solar_result_t;
+
+/**
+ * @brief Sunrise and sunset of a date
+ *
+ * @param year Year (e.g. 2025)
+ * @param month Month 1-12
+ * @param day Day of month 1-31
+ * @param latitude Latitude in degrees (north positive)
+ * @param longitude Longitude in degrees (east positive)
+ * @param sunrise_minutes Set to sunrise in minutes after 00:00 UTC of the date
+ * @param sunset_minutes Set to sunset in minutes after 00:00 UTC of the date
+ *                       (both rounded to the minute; may be outside 0-1439 far from Greenwich)
+ * @return SOLAR_OK, or SOLAR_ALWAYS_UP / SOLAR_ALWAYS_DOWN (times not set)
+ */
+solar_result_t solar_sun_times(int year, int month, int day, float latitude, float longitude,
+                               int *sunrise_minutes, int *sunset_minutes);
+
+#endif // SOLAR_POSITION_H
@@ -0,0 +1,45 @@
+#ifndef WEATHER_DATA_H
+#define WEATHER_DATA_H
+
+#include <stdbool.h>
+
+/**
+ * @file weather_data.h
+ * @brief Forecast result shared by the fetcher, the parser and diagnostics
+ *
+ * Plain data with no ESP-IDF dependencies, so the forecast parser can be
+ * built and benchmarked on the host.
+ */
+
+// Maximum number of daytime hours (conservative estimate: 18 hours max)
+#define MAX_DAYTIME_HOURS 18
+
+// Weather data structure
+typedef struct {
+    float tomorrow_cloudcover;  // Cloud cover percentage for tomorrow (0-100)
+    bool valid;                  // Whether the data is valid
+
+    // Diagnostic data (only populated if HW_WEATHER_DIAGNOSTICS_ENABLED is true)
+    int daytime_hours[MAX_DAYTIME_HOURS];      // Hour values for daytime (e.g., [7, 8, 9, ..., 17])
+    float hourly_cloudcover[MAX_DAYTIME_HOURS]; // Cloudcover for each daytime hour
+    int num_daytime_hours;                      // Number of valid daytime hours
+    int sunrise_hour;                           // Tomorrow's sunrise hour (24h format)
+    int sunrise_minute;                         // Tomorrow's sunrise minute
+    int sunset_hour;                            // Tomorrow's sunset hour (24h format)
+    int sunset_minute;                          // Tomorrow's sunset minute
+    char tomorrow_date[11];                     // Tomorrow's date "YYYY-MM-DD"
+    int tls_handshake_ms;                       // TLS handshake duration of the fetch
+    bool tls_resumed;                           // TLS session was resumed (abbreviated handshake)
+    int response_bytes;                         // Body bytes received (compressed size for gzip)
+    bool response_gzip;                         // Body was gzip-compressed
+    bool response_proxy;                        // Served by the LAN forecast proxy (no TLS)
+    int arena_used;                             // Fetch arena bytes used by the request
+    int arena_peak;                             // Highest fetch arena use since boot
+    bool from_cache;                            // Forecast came from the RTC forecast cache
+    int cache_age_hours;                        // Age of the cached response (from_cache only)
+    bool server_decision;                       // Pin-off hour and LED count decided by the log server
+    int decision_pin_off_hour;                  // Server's pin-off hour (server_decision only)
+    int decision_led_count;                     // Server's LED count (server_decision only)
+} weather_data_t;
+
+#endif // WEATHER_DATA_H
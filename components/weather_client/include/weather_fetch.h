@@ -2,26 +2,7 @@
 #define WEATHER_FETCH_H
 
 #include "esp_err.h"
-#include <stdbool.h>
-
-// Maximum number of daytime hours (conservative estimate: 18 hours max)
-#define MAX_DAYTIME_HOURS 18
-
-// Weather data structure
-typedef struct {
-    float tomorrow_cloudcover;  // Cloud cover percentage for tomorrow (0-100)
-    bool valid;                  // Whether the data is valid
-
-    // Diagnostic data (only populated if HW_WEATHER_DIAGNOSTICS_ENABLED is true)
-    int daytime_hours[MAX_DAYTIME_HOURS];      // Hour values for daytime (e.g., [7, 8, 9, ..., 17])
-    float hourly_cloudcover[MAX_DAYTIME_HOURS]; // Cloudcover for each daytime hour
-    int num_daytime_hours;                      // Number of valid daytime hours
-    int sunrise_hour;                           // Tomorrow's sunrise hour (24h format)
-    int sunrise_minute;                         // Tomorrow's sunrise minute
-    int sunset_hour;                            // Tomorrow's sunset hour (24h format)
-    int sunset_minute;                          // Tomorrow's sunset minute
-    char tomorrow_date[11];                     // Tomorrow's date "YYYY-MM-DD"
-} weather_data_t;
+#include "weather_data.h"
 
 /**
  * @brief Fetch weather forecast from Open-Meteo API
@@ -36,4 +17,18 @@ typedef struct {
  */
 esp_err_t fetch_weather_forecast(float latitude, float longitude, weather_data_t *weather_data);
 
+/**
+ * @brief Tomorrow's forecast from the RTC forecast cache
+ *
+ * Every successful fetch keeps HW_FORECAST_CACHE_DAYS days in RTC memory, so
+ * later wakes can use them without WiFi. fetch_weather_forecast() also falls
+ * back to the cache when the request fails. Needs a valid clock.
+ *
+ * @param max_age_hours Maximum age of the cached response in hours (0 = any age)
+ * @param weather_data Pointer to weather_data_t to store the result (from_cache is set)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if tomorrow is not cached,
+ *         ESP_ERR_INVALID_STATE if the cached response is too old
+ */
+esp_err_t weather_forecast_from_cache(int max_age_hours, weather_data_t *weather_data);
+
 #endif // WEATHER_FETCH_H
@@ -0,0 +1,102 @@
+#include "solar_position.h"
+#include <math.h>
+#include <stdbool.h>
+
+#define DEG_TO_RAD 0.017453292519943295f
+#define RAD_TO_DEG 57.29577951308232f
+
+// Sun below the horizon at sunrise/sunset: refraction (34') plus solar radius (16')
+#define SUNRISE_ZENITH_DEG 90.833f
+
+// Days from 1970-01-01 to a civil date (proleptic Gregorian calendar)
+static long days_from_civil(int year, int month, int day) {
+    year -= (month <= 2) ? 1 : 0;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yoe = year - era * 400;
+    long doy = (153L * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Angle in degrees reduced to [0, 360)
+static float wrap_degrees(float degrees) {
+    degrees = fmodf(degrees, 360.0f);
+    return (degrees < 0.0f) ? degrees + 360.0f : degrees;
+}
+
+// Sun declination (radians) and equation of time (minutes) at a time given in
+// days from J2000.0 (2000-01-01 12:00 UTC)
+static void sun_at(float days, float *declination, float *equation_of_time) {
+    float t = days / 36525.0f;  // Julian centuries
+
+    // Mean longitude and mean anomaly, reduced per day to keep float precision
+    float mean_longitude = wrap_degrees(280.46646f + 0.98564736f * days + 0.0003032f * t * t) * DEG_TO_RAD;
+    float mean_anomaly = wrap_degrees(357.52911f + 0.98560028f * days - 0.0001537f * t * t) * DEG_TO_RAD;
+    float eccentricity = 0.016708634f - t * (0.000042037f + 0.0000001267f * t);
+
+    float center = sinf(mean_anomaly) * (1.914602f - t * (0.004817f + 0.000014f * t)) +
+                   sinf(2.0f * mean_anomaly) * (0.019993f - 0.000101f * t) +
+                   sinf(3.0f * mean_anomaly) * 0.000289f;
+    float omega = (125.04f - 1934.136f * t) * DEG_TO_RAD;
+    float apparent_longitude = (mean_longitude * RAD_TO_DEG + center - 0.00569f - 0.00478f * sinf(omega)) * DEG_TO_RAD;
+
+    float mean_obliquity = 23.0f + (26.0f + (21.448f - t * (46.815f + t * (0.00059f - t * 0.001813f))) / 60.0f) / 60.0f;
+    float obliquity = (mean_obliquity + 0.00256f * cosf(omega)) * DEG_TO_RAD;
+
+    *declination = asinf(sinf(obliquity) * sinf(apparent_longitude));
+
+    float y = tanf(obliquity / 2.0f);
+    y *= y;
+    float eot = y * sinf(2.0f * mean_longitude) -
+                2.0f * eccentricity * sinf(mean_anomaly) +
+                4.0f * eccentricity * y * sinf(mean_anomaly) * cosf(2.0f * mean_longitude) -
+                0.5f * y * y * sinf(4.0f * mean_longitude) -
+                1.25f * eccentricity * eccentricity * sinf(2.0f * mean_anomaly);
+    *equation_of_time = 4.0f * eot * RAD_TO_DEG;
+}
+
+// Sunrise (rising) or sunset in minutes after 00:00 UTC, with the sun taken at
+// `minutes`; false if the sun does not cross the horizon that day
+static bool event_time(float day_start, float minutes, float latitude, float longitude, bool rising,
+                       float *result, solar_result_t *polar) {
+    float declination, equation_of_time;
+    sun_at(day_start + minutes / 1440.0f, &declination, &equation_of_time);
+
+    float lat = latitude * DEG_TO_RAD;
+    float cos_hour_angle = cosf(SUNRISE_ZENITH_DEG * DEG_TO_RAD) / (cosf(lat) * cosf(declination)) -
+                           tanf(lat) * tanf(declination);
+    if (cos_hour_angle > 1.0f) {
+        *polar = SOLAR_ALWAYS_DOWN;
+        return false;
+    }
+    if (cos_hour_angle < -1.0f) {
+        *polar = SOLAR_ALWAYS_UP;
+        return false;
+    }
+
+    float hour_angle = acosf(cos_hour_angle) * RAD_TO_DEG;
+    float solar_noon = 720.0f - 4.0f * longitude - equation_of_time;
+    *result = solar_noon + (rising ? -4.0f : 4.0f) * hour_angle;
+    return true;
+}
+
+solar_result_t solar_sun_times(int year, int month, int day, float latitude, float longitude,
+                               int *sunrise_minutes, int *sunset_minutes) {
+    // 00:00 UTC of the date in days from J2000.0
+    float day_start = (float)(days_from_civil(year, month, day) - days_from_civil(2000, 1, 1)) - 0.5f;
+
+    // First estimate with the sun at solar noon, then once more at the estimated time
+    float noon = 720.0f - 4.0f * longitude;
+    float sunrise, sunset;
+    solar_result_t polar = SOLAR_OK;
+    if (!event_time(day_start, noon, latitude, longitude, true, &sunrise, &polar) ||
+        !event_time(day_start, noon, latitude, longitude, false, &sunset, &polar) ||
+        !event_time(day_start, sunrise, latitude, longitude, true, &sunrise, &polar) ||
+        !event_time(day_start, sunset, latitude, longitude, false, &sunset, &polar)) {
+        return polar;
+    }
+
+    *sunrise_minutes = (int)floorf(sunrise + 0.5f);
+    *sunset_minutes = (int)floorf(sunset + 0.5f);
+    return SOLAR_OK;
+}
@@ -1,235 +1,326 @@
 #include "weather_fetch.h"
+#include "forecast_cache.h"
+#include "forecast_decision.h"
+#include "forecast_query.h"
+#include "https_stream.h"
+#include "solar_position.h"
+#include "clock_service.h"
+#include "timezone_helper.h"
 #include "hardware_config.h"
-#include "esp_http_client.h"
+#include "esp_attr.h"
 #include "esp_log.h"
-#include "esp_crt_bundle.h"
-#include "cJSON.h"
+#include <stdio.h>
 #include <string.h>
 
+#if HW_WEATHER_PROXY_ENABLED || HW_WEATHER_DECISION_ENABLED
+    #if !__has_include("config.h")
+        #error "config.h not found! Please copy components/hardware_config/include/config.h.example to components/hardware_config/include/config.h"
+    #endif
+    #include "config.h"
+    #if HW_WEATHER_PROXY_ENABLED && !defined(WEATHER_PROXY_URL)
+        #error "HW_WEATHER_PROXY_ENABLED needs WEATHER_PROXY_URL in config.h, see config.h.example"
+    #endif
+    #if HW_WEATHER_DECISION_ENABLED && !defined(WEATHER_DECISION_URL)
+        #error "HW_WEATHER_DECISION_ENABLED needs WEATHER_DECISION_URL in config.h, see config.h.example"
+    #endif
+#endif
+
 static const char *TAG = "WEATHER_FETCH";
 
-static esp_err_t http_event_handler(esp_http_client_event_t *evt) {
-    static int output_len;
-    switch(evt->event_id) {
-        case HTTP_EVENT_ERROR:
-            ESP_LOGD(TAG, "HTTP_EVENT_ERROR");
-            break;
-        case HTTP_EVENT_ON_CONNECTED:
-            ESP_LOGD(TAG, "HTTP_EVENT_ON_CONNECTED");
-            break;
-        case HTTP_EVENT_HEADER_SENT:
-            ESP_LOGD(TAG, "HTTP_EVENT_HEADER_SENT");
-            break;
-        case HTTP_EVENT_ON_HEADER:
-            ESP_LOGD(TAG, "HTTP_EVENT_ON_HEADER, key=%s, value=%s", evt->header_key, evt->header_value);
-            break;
-        case HTTP_EVENT_ON_DATA:
-            ESP_LOGD(TAG, "HTTP_EVENT_ON_DATA, len=%d", evt->data_len);
-            // Copy data for both chunked and non-chunked responses
-            if (evt->user_data) {
-                memcpy(evt->user_data + output_len, evt->data, evt->data_len);
-                output_len += evt->data_len;
-            }
-            break;
-        case HTTP_EVENT_ON_FINISH:
-            ESP_LOGD(TAG, "HTTP_EVENT_ON_FINISH");
-            output_len = 0;
-            break;
-        case HTTP_EVENT_DISCONNECTED:
-            ESP_LOGI(TAG, "HTTP_EVENT_DISCONNECTED");
-            output_len = 0;
-            break;
-        default:
-            break;
+#define OPEN_METEO_HOST "api.open-meteo.com"
+
+_Static_assert(HW_FORECAST_CACHE_DAYS >= 1 && HW_FORECAST_CACHE_DAYS <= FORECAST_CACHE_DAYS,
+               "HW_FORECAST_CACHE_DAYS must be between 1 and FORECAST_CACHE_DAYS");
+
+// Days of the last successful response (persists during deep sleep)
+RTC_DATA_ATTR static forecast_cache_t s_forecast_cache;
+
+_Static_assert(sizeof(s_forecast_cache) <= HW_RTC_BUDGET_FORECAST_CACHE,
+               "Forecast cache exceeds HW_RTC_BUDGET_FORECAST_CACHE");
+
+// Response body chunks go straight into the streaming parser (no body buffer)
+static void on_body(const char *data, size_t len, void *ctx) {
+    forecast_decoder_feed((forecast_decoder_t *)ctx, data, len);
+}
+
+// Sunrise and sunset of a day that has none (no longer requested), computed
+// for the location and converted to the local time of the hourly values: the
+// response's UTC offset (utc_offset NULL = the device's time zone)
+static void add_day_sun_times(forecast_day_t *day, float latitude, float longitude, const int32_t *utc_offset) {
+    datetime_t noon_utc = {.hour = 12};
+    int sunrise, sunset, offset_seconds;
+    if (day->sunrise_minutes >= 0 || day->sunset_minutes >= 0 ||
+        sscanf(day->date, "%4d-%2d-%2d", &noon_utc.year, &noon_utc.month, &noon_utc.day) != 3 ||
+        solar_sun_times(noon_utc.year, noon_utc.month, noon_utc.day, latitude, longitude,
+                        &sunrise, &sunset) != SOLAR_OK) {
+        return;
+    }
+    if (utc_offset) {
+        offset_seconds = (int)*utc_offset;
+    } else if (get_timezone_offset(&noon_utc, &offset_seconds) != ESP_OK) {
+        return;
+    }
+
+    sunrise += offset_seconds / 60;
+    sunset += offset_seconds / 60;
+    day->sunrise_minutes = (int16_t)((sunrise < 0) ? 0 : sunrise);
+    day->sunset_minutes = (int16_t)((sunset > 24 * 60 - 1) ? 24 * 60 - 1 : sunset);
+}
+
+static void add_sun_times(forecast_values_t *values, float latitude, float longitude) {
+    if (!values->has_utc_offset) {
+        ESP_LOGW(TAG, "No utc_offset_seconds in the response, using the device time zone for sun times");
+    }
+    for (int i = 0; i < values->num_days; i++) {
+        add_day_sun_times(&values->days[i], latitude, longitude,
+                          values->has_utc_offset ? &values->utc_offset_seconds : NULL);
+    }
+}
+
+// Send the forecast request: through the LAN forecast proxy when enabled (plain
+// HTTP, no TLS), directly to Open-Meteo otherwise or when the proxy fails
+static esp_err_t request_forecast(const forecast_query_t *query, const char *path, const char *conditional,
+                                  forecast_decoder_t *decoder, https_stream_stats_t *stats, bool *via_proxy) {
+    *via_proxy = false;
+#if HW_WEATHER_PROXY_ENABLED
+    char url[256];
+    if (snprintf(url, sizeof(url), "%s%s", WEATHER_PROXY_URL, strchr(path, '?')) < (int)sizeof(url)) {
+        ESP_LOGI(TAG, "Fetching weather from proxy: %s%s", url, conditional[0] ? " (conditional)" : "");
+        esp_err_t err = http_stream_get(url, conditional, 10000, on_body, decoder, stats);
+        if (err == ESP_OK && (stats->status_code == 200 || stats->status_code == 304)) {
+            *via_proxy = true;
+            return ESP_OK;
+        }
+        ESP_LOGW(TAG, "Forecast proxy failed (%s, HTTP %d), falling back to Open-Meteo",
+                 esp_err_to_name(err), stats->status_code);
+
+        // Whatever the proxy sent (e.g. an error page) must not reach the Open-Meteo parse
+        forecast_decoder_init(decoder, query->format, query->date);
+    }
+#else
+    (void)query;
+#endif
+
+    ESP_LOGI(TAG, "Fetching weather from: https://" OPEN_METEO_HOST "%s%s", path,
+             conditional[0] ? " (conditional)" : "");
+
+    // TLS session of the previous fetch is resumed when the server accepts it
+    return https_stream_get(OPEN_METEO_HOST, path, conditional, 10000, on_body, decoder, stats);
+}
+
+#if HW_WEATHER_DECISION_ENABLED
+// Decision record body (one extra byte to notice a longer response)
+typedef struct {
+    uint8_t data[FORECAST_DECISION_SIZE + 1];
+    size_t len;
+} decision_body_t;
+
+static void on_decision_body(const char *data, size_t len, void *ctx) {
+    decision_body_t *body = (decision_body_t *)ctx;
+    size_t room = sizeof(body->data) - body->len;
+    size_t n = (len < room) ? len : room;
+    memcpy(body->data + body->len, data, n);
+    body->len += n;
+}
+
+// Tomorrow's pin-off hour and LED count as decided by the log server. The
+// hourly values and the local sun times still go through forecast_day_summarize()
+// for the diagnostics; the average and the decision are the server's
+static esp_err_t fetch_decision(float latitude, float longitude, const char *date,
+                                weather_data_t *weather_data, https_stream_stats_t *stats) {
+    char url[192];
+    if (snprintf(url, sizeof(url), "%s?latitude=%.4f&longitude=%.4f&date=%s",
+                 WEATHER_DECISION_URL, latitude, longitude, date) >= (int)sizeof(url)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    ESP_LOGI(TAG, "Fetching decision from: %s", url);
+    decision_body_t body = {.len = 0};
+    esp_err_t err = http_stream_get(url, NULL, 10000, on_decision_body, &body, stats);
+    if (err != ESP_OK || stats->status_code != 200) {
+        ESP_LOGW(TAG, "Decision request failed (%s, HTTP %d)", esp_err_to_name(err), stats->status_code);
+        return ESP_FAIL;
+    }
+
+    forecast_decision_t decision;
+    forecast_decision_result_t result = forecast_decision_decode(body.data, body.len, &decision);
+    if (result != FORECAST_DECISION_OK) {
+        ESP_LOGW(TAG, "Decision record rejected (error %d, %u bytes)", result, (unsigned)body.len);
+        return ESP_FAIL;
+    }
+    if (strcmp(decision.day.date, date) != 0) {
+        ESP_LOGW(TAG, "Decision is for %s, expected %s", decision.day.date, date);
+        return ESP_FAIL;
+    }
+
+    // The record carries no UTC offset; its hours are local at the device's own site
+    add_day_sun_times(&decision.day, latitude, longitude, NULL);
+    forecast_day_summarize(&decision.day, weather_data, NULL, NULL);
+
+    weather_data->tomorrow_cloudcover = decision.avg_cloudcover;
+    weather_data->valid = true;
+    weather_data->server_decision = true;
+    weather_data->decision_pin_off_hour = decision.pin_off_hour;
+    weather_data->decision_led_count = decision.led_count;
+
+    ESP_LOGI(TAG, "Server decision for %s: %.1f%% -> pin off at %d:00, %d LEDs",
+             date, decision.avg_cloudcover, decision.pin_off_hour, decision.led_count);
+    return ESP_OK;
+}
+#endif
+
+// Tomorrow's local date as "YYYY-MM-DD" ("" if the clock is not set)
+static void get_tomorrow_date(char *buf, size_t size) {
+    datetime_t local_time;
+    buf[0] = '\0';
+    if (clock_now_local(&local_time) == ESP_OK) {
+        forecast_query_next_date(local_time.year, local_time.month, local_time.day, buf, size);
+    }
+}
+
+// Forecast for a date from the RTC cache; max_age_hours <= 0 accepts any age
+static esp_err_t forecast_from_cache(const char *date, int max_age_hours, weather_data_t *weather_data) {
+    if (date[0] == '\0' || !forecast_cache_valid(&s_forecast_cache)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const forecast_day_t *day = forecast_cache_find(&s_forecast_cache, date);
+    if (!day) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    int64_t age_seconds = (int64_t)clock_now_epoch() - s_forecast_cache.fetched_at;
+    if (max_age_hours > 0 && age_seconds > (int64_t)max_age_hours * 3600) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (forecast_day_summarize(day, weather_data, NULL, NULL) != FORECAST_PARSE_OK) {
+        return ESP_ERR_NOT_FOUND;
     }
+    weather_data->from_cache = true;
+    weather_data->cache_age_hours = (int)(age_seconds / 3600);
+
+    ESP_LOGI(TAG, "Cached forecast for %s (%d h old, %d days cached): %.1f%% (avg of %d hours)",
+             date, weather_data->cache_age_hours, s_forecast_cache.num_days,
+             weather_data->tomorrow_cloudcover, weather_data->num_daytime_hours);
     return ESP_OK;
 }
 
+esp_err_t weather_forecast_from_cache(int max_age_hours, weather_data_t *weather_data) {
+    if (!weather_data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char tomorrow[11];
+    get_tomorrow_date(tomorrow, sizeof(tomorrow));
+    return forecast_from_cache(tomorrow, max_age_hours, weather_data);
+}
+
 esp_err_t fetch_weather_forecast(float latitude, float longitude, weather_data_t *weather_data) {
     if (!weather_data) {
         return ESP_ERR_INVALID_ARG;
     }
 
+    memset(weather_data, 0, sizeof(*weather_data));
     weather_data->valid = false;
-    weather_data->tomorrow_cloudcover = 0.0f;
-    weather_data->num_daytime_hours = 0;
     weather_data->sunrise_hour = -1;
     weather_data->sunrise_minute = -1;
     weather_data->sunset_hour = -1;
     weather_data->sunset_minute = -1;
-    weather_data->tomorrow_date[0] = '\0';
-    memset(weather_data->daytime_hours, 0, sizeof(weather_data->daytime_hours));
-    memset(weather_data->hourly_cloudcover, 0, sizeof(weather_data->hourly_cloudcover));
-
-    char url[256];
-    snprintf(url, sizeof(url),
-             "https://api.open-meteo.com/v1/forecast?latitude=%.2f&longitude=%.2f&daily=sunrise,sunset&hourly=cloudcover&forecast_days=2&timezone=auto",
-             latitude, longitude);
-
-    ESP_LOGI(TAG, "Fetching weather from: %s", url);
-
-    char response_buffer[2048] = {0};
 
-    esp_http_client_config_t config = {
-        .url = url,
-        .event_handler = http_event_handler,
-        .user_data = response_buffer,
-        .timeout_ms = 10000,
-        .crt_bundle_attach = esp_crt_bundle_attach,
+    // Tomorrow is the first day kept; without a valid clock the parsers take the second day
+    char tomorrow[11];
+    get_tomorrow_date(tomorrow, sizeof(tomorrow));
+
+    https_stream_stats_t stats;
+#if HW_WEATHER_DECISION_ENABLED
+    // 32 bytes instead of a forecast: the server has already averaged and mapped it
+    if (tomorrow[0] && fetch_decision(latitude, longitude, tomorrow, weather_data, &stats) == ESP_OK) {
+        weather_data->response_bytes = (int)stats.body_bytes;
+        weather_data->response_proxy = true;
+        weather_data->arena_used = (int)stats.arena_used;
+        weather_data->arena_peak = (int)stats.arena_peak;
+        return ESP_OK;
+    }
+#endif
+
+    forecast_query_t query = {
+        .latitude = latitude,
+        .longitude = longitude,
+        .date = tomorrow[0] ? tomorrow : NULL,
+        .days = HW_FORECAST_CACHE_DAYS,
+        .format = HW_FORECAST_FORMAT_CSV ? FORECAST_FORMAT_CSV : FORECAST_FORMAT_JSON,
     };
+    char path[192];
+    if (forecast_query_build(&query, path, sizeof(path)) >= (int)sizeof(path)) {
+        ESP_LOGE(TAG, "Forecast request path too long");
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint32_t query_hash = forecast_cache_crc32(path, strlen(path));
+
+    // Same request as the cached response (the path has no dates) and the cache
+    // still holds tomorrow: let the server answer 304 if nothing changed
+    char conditional[128] = "";
+    bool cache_matches = query.date && forecast_cache_valid(&s_forecast_cache) &&
+                         s_forecast_cache.query_hash == query_hash &&
+                         forecast_cache_find(&s_forecast_cache, query.date) != NULL;
+    if (cache_matches) {
+        int len = 0;
+        if (s_forecast_cache.etag[0]) {
+            len += snprintf(conditional + len, sizeof(conditional) - len,
+                            "If-None-Match: %s\r\n", s_forecast_cache.etag);
+        }
+        if (s_forecast_cache.last_modified[0] && len < (int)sizeof(conditional)) {
+            snprintf(conditional + len, sizeof(conditional) - len,
+                     "If-Modified-Since: %s\r\n", s_forecast_cache.last_modified);
+        }
+    }
 
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    esp_err_t err = esp_http_client_perform(client);
+    // Fixed-size parser state instead of a response buffer and a JSON tree
+    forecast_decoder_t decoder;
+    forecast_decoder_init(&decoder, query.format, query.date);
 
-    if (err == ESP_OK) {
-        int status_code = esp_http_client_get_status_code(client);
-        ESP_LOGI(TAG, "HTTP GET Status = %d, content_length = %lld",
-                status_code, esp_http_client_get_content_length(client));
-
-        if (status_code == 200) {
-            cJSON *json = cJSON_Parse(response_buffer);
-            if (json) {
-                // Parse daily sunrise/sunset data first
-                int sunrise_hour = -1;
-                int sunrise_minute = -1;
-                int sunset_hour = -1;
-                int sunset_minute = -1;
-                char tomorrow_date[11] = {0};  // "2025-10-20"
-
-                cJSON *daily = cJSON_GetObjectItem(json, "daily");
-                if (daily) {
-                    cJSON *daily_time = cJSON_GetObjectItem(daily, "time");
-                    cJSON *sunrise_array = cJSON_GetObjectItem(daily, "sunrise");
-                    cJSON *sunset_array = cJSON_GetObjectItem(daily, "sunset");
-
-                    if (daily_time && cJSON_IsArray(daily_time) &&
-                        sunrise_array && cJSON_IsArray(sunrise_array) &&
-                        sunset_array && cJSON_IsArray(sunset_array)) {
-
-                        int daily_size = cJSON_GetArraySize(daily_time);
-                        if (daily_size >= 2) {
-                            // Get tomorrow's date (index 1)
-                            cJSON *tomorrow_date_item = cJSON_GetArrayItem(daily_time, 1);
-                            if (tomorrow_date_item && cJSON_IsString(tomorrow_date_item)) {
-                                strncpy(tomorrow_date, cJSON_GetStringValue(tomorrow_date_item), 10);
-                                strncpy(weather_data->tomorrow_date, tomorrow_date, 10);
-                                weather_data->tomorrow_date[10] = '\0';
-                            }
-
-                            // Get tomorrow's sunrise (index 1)
-                            cJSON *sunrise_item = cJSON_GetArrayItem(sunrise_array, 1);
-                            if (sunrise_item && cJSON_IsString(sunrise_item)) {
-                                const char *sunrise_str = cJSON_GetStringValue(sunrise_item);
-                                // Extract hour and minute from ISO 8601: "2025-10-20T06:23"
-                                sscanf(sunrise_str + 11, "%d:%d", &sunrise_hour, &sunrise_minute);
-                                weather_data->sunrise_hour = sunrise_hour;
-                                weather_data->sunrise_minute = sunrise_minute;
-                            }
-
-                            // Get tomorrow's sunset (index 1)
-                            cJSON *sunset_item = cJSON_GetArrayItem(sunset_array, 1);
-                            if (sunset_item && cJSON_IsString(sunset_item)) {
-                                const char *sunset_str = cJSON_GetStringValue(sunset_item);
-                                // Extract hour and minute from ISO 8601: "2025-10-20T18:47"
-                                sscanf(sunset_str + 11, "%d:%d", &sunset_hour, &sunset_minute);
-                                weather_data->sunset_hour = sunset_hour;
-                                weather_data->sunset_minute = sunset_minute;
-                            }
-                        }
-                    }
-                }
+    bool via_proxy;
+    esp_err_t err = request_forecast(&query, path, conditional, &decoder, &stats, &via_proxy);
 
-                // Default to 6 AM - 6 PM if sunrise/sunset parsing failed
-                int start_hour = 6;
-                if (sunrise_hour >= 0 && sunrise_minute >= 0) {
-                    // Round up: if minute >= 30, add 2 hours; otherwise add 1 hour
-                    start_hour = (sunrise_minute >= 30) ? (sunrise_hour + 2) : (sunrise_hour + 1);
-                }
-                int end_hour = (sunset_hour >= 0) ? (sunset_hour - 1) : 18;
-
-                ESP_LOGI(TAG, "Tomorrow's date: %s, sunrise: %02d:%02d, sunset: %02d:%02d",
-                        tomorrow_date[0] ? tomorrow_date : "unknown",
-                        sunrise_hour, sunrise_minute, sunset_hour, sunset_minute);
-                ESP_LOGI(TAG, "Using hour range for averaging: %d - %d", start_hour, end_hour);
-
-                // Parse hourly cloudcover data
-                cJSON *hourly = cJSON_GetObjectItem(json, "hourly");
-                if (hourly) {
-                    cJSON *time_array = cJSON_GetObjectItem(hourly, "time");
-                    cJSON *cloudcover_array = cJSON_GetObjectItem(hourly, "cloudcover");
-
-                    if (time_array && cJSON_IsArray(time_array) &&
-                        cloudcover_array && cJSON_IsArray(cloudcover_array)) {
-
-                        int array_size = cJSON_GetArraySize(time_array);
-
-                        // Find tomorrow's date by checking if we've moved past hour 0 after the first day
-                        char first_date[11] = {0};  // "2025-10-19"
-                        bool found_tomorrow = false;
-                        float cloudcover_sum = 0.0f;
-                        int daytime_count = 0;
-
-                        for (int i = 0; i < array_size; i++) {
-                            cJSON *time_item = cJSON_GetArrayItem(time_array, i);
-                            cJSON *cloudcover_item = cJSON_GetArrayItem(cloudcover_array, i);
-
-                            if (time_item && cJSON_IsString(time_item) &&
-                                cloudcover_item && cJSON_IsNumber(cloudcover_item)) {
-
-                                const char *timestamp = cJSON_GetStringValue(time_item);
-
-                                // Extract date (first 10 chars: "2025-10-19")
-                                if (i == 0) {
-                                    strncpy(first_date, timestamp, 10);
-                                }
-
-                                // Check if this is tomorrow's data
-                                if (strncmp(timestamp, first_date, 10) != 0) {
-                                    found_tomorrow = true;
-
-                                    // Extract hour from timestamp (e.g., "2025-10-20T14:00" -> 14)
-                                    int hour = 0;
-                                    sscanf(timestamp + 11, "%d", &hour);
-
-                                    // Use dynamic daytime hours based on sunrise/sunset
-                                    if (hour >= start_hour && hour <= end_hour) {
-                                        float cloudcover_value = (float)cJSON_GetNumberValue(cloudcover_item);
-                                        cloudcover_sum += cloudcover_value;
-
-                                        // Store hourly data if within array bounds
-                                        if (daytime_count < MAX_DAYTIME_HOURS) {
-                                            weather_data->daytime_hours[daytime_count] = hour;
-                                            weather_data->hourly_cloudcover[daytime_count] = cloudcover_value;
-                                        }
-                                        daytime_count++;
-                                    }
-                                }
-                            }
-                        }
-
-                        // Store the final count (may be more than MAX_DAYTIME_HOURS but we only store up to the limit)
-                        weather_data->num_daytime_hours = (daytime_count < MAX_DAYTIME_HOURS) ? daytime_count : MAX_DAYTIME_HOURS;
-
-                        if (found_tomorrow && daytime_count > 0) {
-                            weather_data->tomorrow_cloudcover = cloudcover_sum / daytime_count;
-                            weather_data->valid = true;
-                            ESP_LOGI(TAG, "Tomorrow daytime cloud cover: %.1f%% (avg of %d hours)",
-                                    weather_data->tomorrow_cloudcover, daytime_count);
-                        } else {
-                            ESP_LOGE(TAG, "Failed to calculate tomorrow's daytime cloud cover");
-                            err = ESP_FAIL;
-                        }
-                    } else {
-                        ESP_LOGE(TAG, "Failed to parse hourly time or cloudcover arrays");
-                        err = ESP_FAIL;
-                    }
-                } else {
-                    ESP_LOGE(TAG, "Failed to parse hourly object");
-                    err = ESP_FAIL;
+    if (err == ESP_OK) {
+        int status_code = stats.status_code;
+        ESP_LOGI(TAG, "HTTP GET Status = %d", status_code);
+
+        if (status_code == 304 && cache_matches) {
+            // Cached days are still current: nothing to parse
+            ESP_LOGI(TAG, "Forecast not modified since the cached response");
+            forecast_cache_touch(&s_forecast_cache, clock_now_epoch());
+            err = forecast_from_cache(tomorrow, 0, weather_data);
+        } else if (status_code == 200) {
+            add_sun_times(forecast_decoder_values(&decoder), latitude, longitude);
+            forecast_parse_result_t result = forecast_decoder_finish(&decoder, weather_data);
+            const forecast_values_t *values = forecast_decoder_values(&decoder);
+
+            ESP_LOGI(TAG, "Tomorrow's date: %s, sunrise: %02d:%02d, sunset: %02d:%02d",
+                    weather_data->tomorrow_date[0] ? weather_data->tomorrow_date : "unknown",
+                    weather_data->sunrise_hour, weather_data->sunrise_minute,
+                    weather_data->sunset_hour, weather_data->sunset_minute);
+            ESP_LOGI(TAG, "Using hour range for averaging: %d - %d",
+                    values->window_start_hour, values->window_end_hour);
+
+            if (result == FORECAST_PARSE_OK) {
+                ESP_LOGI(TAG, "Tomorrow daytime cloud cover: %.1f%% (avg of %d hours)",
+                        weather_data->tomorrow_cloudcover, weather_data->num_daytime_hours);
+
+                // Keep the following days for wakes without (or with a failed) fetch
+                if (query.date) {
+                    forecast_cache_store(&s_forecast_cache, values, query.date, clock_now_epoch(),
+                                         query_hash, stats.etag, stats.last_modified);
+                    ESP_LOGI(TAG, "Cached %d forecast days%s", s_forecast_cache.num_days,
+                             (stats.etag[0] || stats.last_modified[0]) ? " with validators" : "");
                 }
-                cJSON_Delete(json);
+            } else if (result == FORECAST_PARSE_ERR_NO_DATA) {
+                ESP_LOGE(TAG, "Failed to calculate tomorrow's daytime cloud cover");
+                err = ESP_FAIL;
             } else {
-                ESP_LOGE(TAG, "Failed to parse JSON response");
+                ESP_LOGE(TAG, "Failed to parse %s response (%s)", forecast_format_name(query.format),
+                        result == FORECAST_PARSE_ERR_INCOMPLETE ? "incomplete" : "syntax error");
                 err = ESP_FAIL;
             }
         } else {
@@ -240,6 +331,19 @@ esp_err_t fetch_weather_forecast(float latitude, float longitude, weather_data_t
         ESP_LOGE(TAG, "HTTP GET request failed: %s", esp_err_to_name(err));
     }
 
-    esp_http_client_cleanup(client);
+    // A cached forecast for tomorrow beats the hardcoded defaults, however old
+    if (err != ESP_OK && forecast_from_cache(tomorrow, 0, weather_data) == ESP_OK) {
+        ESP_LOGW(TAG, "Fetch failed, using the cached forecast instead");
+        err = ESP_OK;
+    }
+
+    // Transport details of this request (set last, the summaries above clear weather_data)
+    weather_data->tls_handshake_ms = (int)(stats.handshake_us / 1000);
+    weather_data->tls_resumed = stats.resumed;
+    weather_data->response_bytes = (int)stats.body_bytes;
+    weather_data->response_gzip = stats.gzip;
+    weather_data->response_proxy = via_proxy;
+    weather_data->arena_used = (int)stats.arena_used;
+    weather_data->arena_peak = (int)stats.arena_peak;
     return err;
 }
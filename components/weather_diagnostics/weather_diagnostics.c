@@ -1,8 +1,9 @@
 #include "weather_diagnostics.h"
 #include "hardware_config.h"
-#include "rtc_helper.h"
-#include "timezone_helper.h"
+#include "clock_service.h"
 #include "cloudcover_leds.h"
+#include "wake_profiler.h"
+#include "power_profile.h"
 #include "esp_log.h"
 #include "esp_http_client.h"
 #include <string.h>
@@ -26,26 +27,11 @@
 
 static const char *TAG = "WEATHER_DIAG";
 
-// Get current timestamp from RTC (in local time)
-static void get_timestamp(char *timestamp_str) {
-    datetime_t utc_time, local_time;
+// Room for the wake profile object (~90 bytes per phase)
+#define WAKE_PROFILE_JSON_SIZE 1280
 
-    // Read UTC time from RTC
-    if (rtc_read_time(&utc_time) != ESP_OK) {
-        strcpy(timestamp_str, "0000-00-00 00:00:00");
-        return;
-    }
-
-    // Convert to local time
-    if (utc_to_local(&utc_time, &local_time) != ESP_OK) {
-        strcpy(timestamp_str, "0000-00-00 00:00:00");
-        return;
-    }
-
-    snprintf(timestamp_str, 20, "%04d-%02d-%02d %02d:%02d:%02d",
-             local_time.year, local_time.month, local_time.day,
-             local_time.hour, local_time.minute, local_time.second);
-}
+// Room for the power profile object
+#define POWER_PROFILE_JSON_SIZE 96
 
 esp_err_t send_weather_diagnostics(const weather_data_t *weather_data, int pin_off_hour, int led_count) {
 #if !HW_WEATHER_DIAGNOSTICS_ENABLED
@@ -59,11 +45,11 @@ esp_err_t send_weather_diagnostics(const weather_data_t *weather_data, int pin_o
 
     // Get current timestamp
     char timestamp[20];
-    get_timestamp(timestamp);
+    clock_format_local(timestamp, sizeof(timestamp));
 
     // Build JSON payload
-    // Estimate: Base (~150) + hourly data (num_hours * ~30) + safety margin
-    int json_size = 512 + (weather_data->num_daytime_hours * 40);
+    // Estimate: Base (~150) + hourly data (num_hours * ~30) + wake profile + safety margin
+    int json_size = 512 + (weather_data->num_daytime_hours * 40) + WAKE_PROFILE_JSON_SIZE + POWER_PROFILE_JSON_SIZE;
     char *json_payload = malloc(json_size);
     if (!json_payload) {
         ESP_LOGE(TAG, "Failed to allocate JSON buffer (%d bytes)", json_size);
@@ -91,7 +77,45 @@ esp_err_t send_weather_diagnostics(const weather_data_t *weather_data, int pin_o
                           weather_data->hourly_cloudcover[i]);
     }
 
-    offset += snprintf(json_payload + offset, json_size - offset, "]}");
+    offset += snprintf(json_payload + offset, json_size - offset, "]");
+
+    // TLS handshake of this fetch (full or resumed)
+    offset += snprintf(json_payload + offset, json_size - offset,
+                      ",\"tls\":{\"handshake_ms\":%d,\"resumed\":%s}",
+                      weather_data->tls_handshake_ms, weather_data->tls_resumed ? "true" : "false");
+
+    // Response size over the air
+    offset += snprintf(json_payload + offset, json_size - offset,
+                      ",\"response\":{\"bytes\":%d,\"gzip\":%s,\"proxy\":%s,\"decision\":%s}",
+                      weather_data->response_bytes, weather_data->response_gzip ? "true" : "false",
+                      weather_data->response_proxy ? "true" : "false",
+                      weather_data->server_decision ? "true" : "false");
+
+    // Fetch arena use (working memory of the request)
+    offset += snprintf(json_payload + offset, json_size - offset,
+                      ",\"arena\":{\"used\":%d,\"peak\":%d,\"size\":%d}",
+                      weather_data->arena_used, weather_data->arena_peak, HW_FETCH_ARENA_SIZE);
+
+    // Forecast source (fresh response or RTC forecast cache)
+    offset += snprintf(json_payload + offset, json_size - offset,
+                      ",\"cache\":{\"used\":%s,\"age_h\":%d}",
+                      weather_data->from_cache ? "true" : "false", weather_data->cache_age_hours);
+
+    // Attach wake cycle timing statistics accumulated since the last upload
+    char profile_json[WAKE_PROFILE_JSON_SIZE];
+    if (wake_profiler_to_json(profile_json, sizeof(profile_json)) > 0) {
+        offset += snprintf(json_payload + offset, json_size - offset,
+                          ",\"wake_profile\":%s", profile_json);
+    }
+
+    // Attach time spent per CPU frequency / light sleep state
+    char power_json[POWER_PROFILE_JSON_SIZE];
+    if (power_profile_to_json(power_json, sizeof(power_json)) > 0) {
+        offset += snprintf(json_payload + offset, json_size - offset,
+                          ",\"power_profile\":%s", power_json);
+    }
+
+    offset += snprintf(json_payload + offset, json_size - offset, "}");
 
     ESP_LOGI(TAG, "Sending diagnostics (%d bytes): %s", offset, json_payload);
 
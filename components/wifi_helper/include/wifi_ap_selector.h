@@ -0,0 +1,75 @@
+#ifndef WIFI_AP_SELECTOR_H
+#define WIFI_AP_SELECTOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file wifi_ap_selector.h
+ * @brief Pick which configured network to try next
+ *
+ * Works on indexes into the credential table. The network that connected last
+ * is tried first, without scanning. The remaining candidates are ranked by the
+ * RSSI cached from the last scan, which only runs after a candidate failed.
+ *
+ * Pure logic with no ESP-IDF dependencies. The cache is meant to live in RTC
+ * memory so the ranking survives deep sleep.
+ */
+
+// Largest credential table the cache can track
+#define WIFI_AP_SELECTOR_MAX 8
+
+// Cached RSSI of a network that was not seen in the last scan (or never scanned)
+#define WIFI_AP_RSSI_UNKNOWN INT8_MIN
+
+typedef struct {
+    bool initialized;
+    int8_t last_good;                    // Index that connected last (-1 = none)
+    int8_t rssi[WIFI_AP_SELECTOR_MAX];   // Best RSSI per index from the last scan
+} wifi_ap_cache_t;
+
+/**
+ * @brief Reset the cache (no last good network, no RSSI)
+ */
+void wifi_ap_cache_reset(wifi_ap_cache_t *cache);
+
+/**
+ * @brief Select the next network to try on this wake
+ *
+ * The last good network comes first. Others follow by cached RSSI, strongest
+ * first, with unknown RSSI last and ties in table order.
+ *
+ * @param cache Selector cache
+ * @param count Number of entries in the credential table
+ * @param tried_mask Bit i set if index i was already tried on this wake
+ * @param skip_unseen Skip networks with unknown RSSI (after a scan this wake)
+ * @return Index to try, or -1 if no candidate is left
+ */
+int wifi_ap_select_next(const wifi_ap_cache_t *cache, int count, uint32_t tried_mask, bool skip_unseen);
+
+/**
+ * @brief Store the RSSI seen for an index in a scan
+ *
+ * Keeps the strongest value when called more than once for the same index
+ * (several APs of one mesh network). Call wifi_ap_cache_clear_rssi() first.
+ */
+void wifi_ap_cache_update_rssi(wifi_ap_cache_t *cache, int index, int rssi);
+
+/**
+ * @brief Forget all cached RSSI values before storing new scan results
+ */
+void wifi_ap_cache_clear_rssi(wifi_ap_cache_t *cache);
+
+/**
+ * @brief Record that an index connected
+ */
+void wifi_ap_cache_record_success(wifi_ap_cache_t *cache, int index);
+
+/**
+ * @brief Record that an index failed to connect
+ *
+ * A failed last good network loses its place at the front.
+ */
+void wifi_ap_cache_record_failure(wifi_ap_cache_t *cache, int index);
+
+#endif // WIFI_AP_SELECTOR_H
@@ -2,6 +2,7 @@
 #define WIFI_HELPER_H
 
 #include "esp_err.h"
+#include <stdint.h>
 
 /**
  * @file wifi_helper.h
@@ -25,7 +26,17 @@ esp_err_t wifi_scan_networks(void);
  * @brief Initialize WiFi station mode
  *
  * This function initializes NVS, network interface, and WiFi.
- * It uses WIFI_SSID and WIFI_PASSWORD from config.h.
+ * It uses the WIFI_CREDENTIALS table from config.h, or WIFI_SSID and
+ * WIFI_PASSWORD when no table is defined.
+ *
+ * The network that connected last is tried first without scanning. If it
+ * fails, one scan ranks the other configured networks by RSSI and they are
+ * tried strongest first, within the HW_WIFI_RADIO_BUDGET_MS budget.
+ *
+ * With HW_WIFI_FAST_CONNECT_ENABLED, the last good AP (BSSID, channel) and
+ * DHCP lease cached in RTC memory are reused: no channel scan and a static IP
+ * instead of DHCP. On failure it falls back to a full scan and DHCP, and a
+ * wake that fails to associate or get an address drops the cache.
  *
  * @return ESP_OK on success, error code otherwise
  */
@@ -34,14 +45,34 @@ esp_err_t wifi_init(void);
 /**
  * @brief Wait for WiFi connection with retry logic
  *
- * Polls for IP address assignment to verify connection.
+ * Blocks on the connection event group until an IP address is assigned or a
+ * fatal disconnect (wrong password, AP not found, ...) is reported. The total
+ * timeout is max_retries * retry_delay_ms.
  *
  * @param max_retries Maximum number of retry attempts
  * @param retry_delay_ms Delay between retries in milliseconds
- * @return ESP_OK if connected, ESP_ERR_TIMEOUT if not connected after max retries
+ * @return ESP_OK if connected, ESP_FAIL on a fatal disconnect,
+ *         ESP_ERR_TIMEOUT if not connected after max retries
  */
 esp_err_t wifi_wait_connected(int max_retries, int retry_delay_ms);
 
+/**
+ * @brief Get the reason code of the last WiFi disconnect
+ *
+ * @return wifi_err_reason_t value (e.g., 201 = NO_AP_FOUND), 0 if none since wifi_init()
+ */
+int wifi_get_last_disconnect_reason(void);
+
+/**
+ * @brief Get the number of consecutive wakes that failed to connect
+ *
+ * Kept in RTC memory across deep sleep and reset by a successful connection.
+ * Used with wifi_reconnect_wake_allowed() to stop trying after repeated failures.
+ *
+ * @return Consecutive failed wakes
+ */
+uint32_t wifi_get_failed_wake_count(void);
+
 /**
  * @brief Shutdown WiFi to save power
  *
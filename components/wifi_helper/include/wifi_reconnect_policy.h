@@ -0,0 +1,69 @@
+#ifndef WIFI_RECONNECT_POLICY_H
+#define WIFI_RECONNECT_POLICY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file wifi_reconnect_policy.h
+ * @brief Decide how to react to a WiFi disconnect
+ *
+ * Picks retry or give-up and a backoff delay from the disconnect reason, the
+ * number of attempts so far and the radio-on time already spent on this wake.
+ * Across deep sleep, wakes that failed to connect are counted; after too many
+ * in a row, WiFi is only attempted again for a required network event.
+ *
+ * Pure logic with no ESP-IDF dependencies. Reason codes are the
+ * wifi_err_reason_t values reported in WIFI_EVENT_STA_DISCONNECTED.
+ */
+
+// Disconnect reason codes (wifi_err_reason_t)
+#define WIFI_RECONNECT_REASON_AUTH_EXPIRE            2
+#define WIFI_RECONNECT_REASON_4WAY_HANDSHAKE_TIMEOUT 15
+#define WIFI_RECONNECT_REASON_NO_AP_FOUND            201
+#define WIFI_RECONNECT_REASON_AUTH_FAIL              202
+#define WIFI_RECONNECT_REASON_HANDSHAKE_TIMEOUT      204
+
+// Reconnect attempts per wake for transient failures (beacon timeout, assoc fail, ...)
+#define WIFI_RECONNECT_MAX_ATTEMPTS 5
+
+// Backoff before the first retry, doubled per attempt up to the maximum
+#define WIFI_RECONNECT_BASE_BACKOFF_MS 250
+#define WIFI_RECONNECT_MAX_BACKOFF_MS  2000
+
+// An AP that is not found gets this many retries (it may be rebooting)
+#define WIFI_RECONNECT_NO_AP_ATTEMPTS 1
+
+typedef enum {
+    WIFI_RECONNECT_RETRY = 0,    // Reconnect after backoff_ms
+    WIFI_RECONNECT_GIVE_UP,      // Stop trying on this wake
+} wifi_reconnect_action_t;
+
+typedef struct {
+    wifi_reconnect_action_t action;
+    uint32_t backoff_ms;         // Delay before reconnecting (RETRY only)
+} wifi_reconnect_decision_t;
+
+/**
+ * @brief Decide what to do after a disconnect
+ *
+ * @param reason Disconnect reason code
+ * @param attempt Reconnect attempts already made on this wake (0 for the first disconnect)
+ * @param radio_on_ms Time since the radio was started on this wake
+ * @param budget_ms Radio-on time budget per wake (0 = no budget)
+ * @return Decision with action and backoff
+ */
+wifi_reconnect_decision_t wifi_reconnect_decide(int reason, int attempt,
+                                                uint32_t radio_on_ms, uint32_t budget_ms);
+
+/**
+ * @brief Check whether a wake should bring WiFi up at all
+ *
+ * @param failed_wakes Consecutive wakes that failed to connect
+ * @param max_failed_wakes Failed wakes after which only required events try again (0 = no limit)
+ * @param required Whether a required network event (e.g., weather fetch) is due
+ * @return true to start WiFi, false to skip it on this wake
+ */
+bool wifi_reconnect_wake_allowed(uint32_t failed_wakes, uint32_t max_failed_wakes, bool required);
+
+#endif // WIFI_RECONNECT_POLICY_H
@@ -0,0 +1,69 @@
+#include "wifi_ap_selector.h"
+
+static bool valid_index(int index) {
+    return index >= 0 && index < WIFI_AP_SELECTOR_MAX;
+}
+
+void wifi_ap_cache_reset(wifi_ap_cache_t *cache) {
+    cache->initialized = true;
+    cache->last_good = -1;
+    wifi_ap_cache_clear_rssi(cache);
+}
+
+int wifi_ap_select_next(const wifi_ap_cache_t *cache, int count, uint32_t tried_mask, bool skip_unseen) {
+    if (count > WIFI_AP_SELECTOR_MAX) {
+        count = WIFI_AP_SELECTOR_MAX;
+    }
+
+    // The last good network goes first, no scan needed to find it
+    int last_good = cache->last_good;
+    if (last_good >= 0 && last_good < count && !(tried_mask & (1u << last_good)) &&
+        !(skip_unseen && cache->rssi[last_good] == WIFI_AP_RSSI_UNKNOWN)) {
+        return last_good;
+    }
+
+    // Strongest untried network; strict comparison keeps table order on ties
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        if (tried_mask & (1u << i)) {
+            continue;
+        }
+        if (skip_unseen && cache->rssi[i] == WIFI_AP_RSSI_UNKNOWN) {
+            continue;
+        }
+        if (best < 0 || cache->rssi[i] > cache->rssi[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void wifi_ap_cache_update_rssi(wifi_ap_cache_t *cache, int index, int rssi) {
+    if (!valid_index(index)) {
+        return;
+    }
+    if (rssi <= WIFI_AP_RSSI_UNKNOWN) {
+        rssi = WIFI_AP_RSSI_UNKNOWN + 1;
+    }
+    if (rssi > cache->rssi[index]) {
+        cache->rssi[index] = (int8_t)rssi;
+    }
+}
+
+void wifi_ap_cache_clear_rssi(wifi_ap_cache_t *cache) {
+    for (int i = 0; i < WIFI_AP_SELECTOR_MAX; i++) {
+        cache->rssi[i] = WIFI_AP_RSSI_UNKNOWN;
+    }
+}
+
+void wifi_ap_cache_record_success(wifi_ap_cache_t *cache, int index) {
+    if (valid_index(index)) {
+        cache->last_good = (int8_t)index;
+    }
+}
+
+void wifi_ap_cache_record_failure(wifi_ap_cache_t *cache, int index) {
+    if (cache->last_good == index) {
+        cache->last_good = -1;
+    }
+}
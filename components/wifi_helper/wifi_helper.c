@@ -1,11 +1,24 @@
 #include "wifi_helper.h"
+#include "wifi_reconnect_policy.h"
+#include "wifi_ap_selector.h"
+#include "hardware_config.h"
+#include "clock_service.h"
+#include "esp_attr.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_netif.h"
+#include "esp_phy_init.h"
+#include "esp_system.h"
+#include "driver/temperature_sensor.h"
 #include "nvs_flash.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
+#include <time.h>
 
 // Include config.h for WiFi credentials (if available)
 #if __has_include("config.h")
@@ -20,12 +33,343 @@
     #define WIFI_PASSWORD "YOUR_WIFI_PASSWORD"
 #endif
 
+typedef struct {
+    const char *ssid;
+    const char *password;
+} wifi_credential_t;
+
+// Networks to connect to: WIFI_CREDENTIALS table from config.h, or the single WIFI_SSID
+#ifdef WIFI_CREDENTIALS
+static const wifi_credential_t s_credentials[] = WIFI_CREDENTIALS;
+#else
+static const wifi_credential_t s_credentials[] = {{WIFI_SSID, WIFI_PASSWORD}};
+#endif
+#define WIFI_CREDENTIAL_COUNT ((int)(sizeof(s_credentials) / sizeof(s_credentials[0])))
+
+_Static_assert(WIFI_CREDENTIAL_COUNT <= WIFI_AP_SELECTOR_MAX, "Too many WIFI_CREDENTIALS entries");
+
 static const char *TAG = "WIFI_HELPER";
 
 // Store event handler instances for cleanup
 static esp_event_handler_instance_t instance_any_id = NULL;
 static esp_event_handler_instance_t instance_got_ip = NULL;
 
+// Connection events signalled to wifi_wait_connected()
+#define WIFI_GOT_IP_BIT BIT0
+#define WIFI_FAIL_BIT   BIT1  // Fatal disconnect, see s_last_disconnect_reason
+
+static EventGroupHandle_t s_wifi_events = NULL;
+static volatile int s_last_disconnect_reason = 0;
+
+// Reconnect state for this wake (see wifi_reconnect_policy.h)
+static esp_timer_handle_t s_reconnect_timer = NULL;
+static int s_reconnect_attempt = 0;
+static int64_t s_radio_start_us = 0;
+static volatile bool s_stopping = false;  // Disconnects during wifi_shutdown() are expected
+
+// Consecutive wakes that failed to connect (persists during deep sleep)
+RTC_DATA_ATTR static uint32_t s_failed_wakes = 0;
+
+// Last good network and scanned RSSI per credential (persists during deep sleep)
+RTC_DATA_ATTR static wifi_ap_cache_t s_ap_cache;
+
+// Network selection state for this wake
+static int s_current_ap = 0;          // Index into s_credentials
+static uint32_t s_tried_mask = 0;     // Indexes tried on this wake
+static bool s_scanned = false;        // RSSI ranking refreshed by a scan on this wake
+static bool s_scan_pending = false;
+
+static uint32_t radio_on_ms(void) {
+    return (uint32_t)((esp_timer_get_time() - s_radio_start_us) / 1000);
+}
+
+static void reconnect_timer_callback(void *arg) {
+    if (!s_stopping) {
+        esp_wifi_connect();
+    }
+}
+
+// Conditions of the last PHY/RF calibration (persists during deep sleep)
+typedef struct {
+    bool valid;
+    float temperature_c;         // Chip temperature at calibration (NAN if unknown)
+    time_t calibrated_at;        // UTC epoch at calibration (0 = unknown)
+} phy_cal_state_t;
+
+RTC_DATA_ATTR static phy_cal_state_t s_phy_cal;
+
+// Read the chip temperature with the internal sensor (NAN on failure)
+static float read_chip_temperature(void) {
+    temperature_sensor_handle_t sensor = NULL;
+    temperature_sensor_config_t config = TEMPERATURE_SENSOR_CONFIG_DEFAULT(-10, 80);
+    float celsius = NAN;
+
+    if (temperature_sensor_install(&config, &sensor) != ESP_OK) {
+        return NAN;
+    }
+    if (temperature_sensor_enable(sensor) == ESP_OK) {
+        if (temperature_sensor_get_celsius(sensor, &celsius) != ESP_OK) {
+            celsius = NAN;
+        }
+        temperature_sensor_disable(sensor);
+    }
+    temperature_sensor_uninstall(sensor);
+    return celsius;
+}
+
+// Decide whether the stored PHY calibration can be reused on this connection
+//
+// ESP-IDF loads the calibration from NVS and skips RF calibration entirely after
+// a deep sleep reset, and runs a partial calibration on other resets. Over days
+// of timer wakes the stored data goes stale, so it is erased (forcing a full
+// calibration that is stored again) when the temperature or age limit is exceeded.
+static void phy_cal_prepare(void) {
+    float temperature = read_chip_temperature();
+    time_t now = clock_now_epoch();  // DS3231-anchored, unlike time(NULL) before SNTP
+    bool deep_sleep_wake = (esp_reset_reason() == ESP_RST_DEEPSLEEP);
+    const char *reason = NULL;
+
+    if (!deep_sleep_wake) {
+        reason = "boot";
+    } else if (!s_phy_cal.valid) {
+        reason = "no calibration record";
+    } else if (!isnan(temperature) && !isnan(s_phy_cal.temperature_c) &&
+               fabsf(temperature - s_phy_cal.temperature_c) > HW_PHY_CAL_MAX_TEMP_DELTA_C) {
+        reason = "temperature change";
+    } else if (now <= 0 || s_phy_cal.calibrated_at <= 0 || now < s_phy_cal.calibrated_at ||
+               now - s_phy_cal.calibrated_at > (time_t)HW_PHY_CAL_MAX_AGE_HOURS * 3600) {
+        reason = "age";
+    }
+
+    if (reason == NULL) {
+        ESP_LOGI(TAG, "Reusing PHY calibration (%.1f C now, %.1f C at calibration, %ld h old)",
+                 temperature, s_phy_cal.temperature_c, (long)((now - s_phy_cal.calibrated_at) / 3600));
+        return;
+    }
+
+    if (deep_sleep_wake) {
+        // No valid data in NVS makes the PHY init run and store a full calibration
+        esp_err_t err = esp_phy_erase_cal_data_in_nvs();
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to erase PHY calibration data: %s", esp_err_to_name(err));
+            return;
+        }
+    }
+
+    ESP_LOGI(TAG, "PHY calibration runs on this connection (%s, %.1f C)", reason, temperature);
+    s_phy_cal.valid = true;
+    s_phy_cal.temperature_c = temperature;
+    s_phy_cal.calibrated_at = now;
+}
+
+// Last good AP and DHCP lease, kept in RTC memory for fast reconnects
+typedef struct {
+    bool valid;
+    char ssid[33];               // SSID the cache belongs to
+    uint8_t bssid[6];
+    uint8_t channel;
+    esp_netif_ip_info_t ip_info; // IP, netmask, gateway
+    esp_ip4_addr_t dns;
+    time_t leased_at;            // UTC epoch of the DHCP exchange (0 = unknown)
+} wifi_fast_connect_t;
+
+RTC_DATA_ATTR static wifi_fast_connect_t s_fast_connect;
+
+_Static_assert(sizeof(s_failed_wakes) + sizeof(s_ap_cache) + sizeof(s_phy_cal) + sizeof(s_fast_connect) <=
+               HW_RTC_BUDGET_WIFI, "WiFi state kept across deep sleep exceeds HW_RTC_BUDGET_WIFI");
+
+// Per-connection state (regular RAM)
+static bool s_fast_connect_attempt = false;  // Connecting to the cached BSSID/channel
+static bool s_static_ip = false;             // Cached lease applied instead of DHCP
+
+static bool fast_connect_usable(void) {
+#if HW_WIFI_FAST_CONNECT_ENABLED
+    return s_fast_connect.valid &&
+           strncmp(s_fast_connect.ssid, s_credentials[s_current_ap].ssid, sizeof(s_fast_connect.ssid)) == 0;
+#else
+    return false;
+#endif
+}
+
+// The cached lease is reused only while it is younger than HW_WIFI_LEASE_REUSE_MAX_HOURS
+static bool cached_lease_fresh(void) {
+    time_t now = clock_now_epoch();
+    return s_fast_connect.leased_at > 0 && now >= s_fast_connect.leased_at &&
+           now - s_fast_connect.leased_at < (time_t)HW_WIFI_LEASE_REUSE_MAX_HOURS * 3600;
+}
+
+// Apply the cached lease as a static IP (DHCP client stopped)
+static void apply_cached_lease(void) {
+    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    if (netif == NULL) {
+        return;
+    }
+
+    esp_err_t err = esp_netif_dhcpc_stop(netif);
+    if (err != ESP_OK && err != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED) {
+        ESP_LOGW(TAG, "Failed to stop DHCP client: %s", esp_err_to_name(err));
+        return;
+    }
+
+    if (esp_netif_set_ip_info(netif, &s_fast_connect.ip_info) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to apply cached IP, using DHCP");
+        esp_netif_dhcpc_start(netif);
+        return;
+    }
+
+    esp_netif_dns_info_t dns_info = {0};
+    dns_info.ip.type = ESP_IPADDR_TYPE_V4;
+    dns_info.ip.u_addr.ip4 = s_fast_connect.dns;
+    esp_netif_set_dns_info(netif, ESP_NETIF_DNS_MAIN, &dns_info);
+
+    s_static_ip = true;
+    ESP_LOGI(TAG, "Using cached IP " IPSTR " (lease %ld min old, renewed after %d h)",
+             IP2STR(&s_fast_connect.ip_info.ip),
+             (long)((clock_now_epoch() - s_fast_connect.leased_at) / 60), HW_WIFI_LEASE_REUSE_MAX_HOURS);
+}
+
+// Remember the AP and the DHCP lease after a successful DHCP exchange
+static void save_fast_connect(const esp_netif_ip_info_t *ip_info) {
+#if HW_WIFI_FAST_CONNECT_ENABLED
+    wifi_ap_record_t ap_info;
+    if (esp_wifi_sta_get_ap_info(&ap_info) != ESP_OK) {
+        return;
+    }
+
+    esp_netif_dns_info_t dns_info = {0};
+    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    if (netif == NULL || esp_netif_get_dns_info(netif, ESP_NETIF_DNS_MAIN, &dns_info) != ESP_OK) {
+        return;
+    }
+
+    strncpy(s_fast_connect.ssid, s_credentials[s_current_ap].ssid, sizeof(s_fast_connect.ssid) - 1);
+    s_fast_connect.ssid[sizeof(s_fast_connect.ssid) - 1] = '\0';
+    memcpy(s_fast_connect.bssid, ap_info.bssid, sizeof(s_fast_connect.bssid));
+    s_fast_connect.channel = ap_info.primary;
+    s_fast_connect.ip_info = *ip_info;
+    s_fast_connect.dns = dns_info.ip.u_addr.ip4;
+    s_fast_connect.leased_at = clock_now_epoch();
+    s_fast_connect.valid = true;
+
+    ESP_LOGI(TAG, "Cached AP " MACSTR " (channel %d) and lease for fast reconnect",
+             MAC2STR(s_fast_connect.bssid), s_fast_connect.channel);
+#else
+    (void)ip_info;
+#endif
+}
+
+// Forget the cached AP and lease; the next wifi_init() does a full scan and DHCP exchange
+static void invalidate_fast_connect(void) {
+    if (s_fast_connect.valid) {
+        ESP_LOGI(TAG, "Fast reconnect cache invalidated, next connect uses scan and DHCP");
+    }
+    s_fast_connect.valid = false;
+}
+
+// Point the station config at a credential, via the cached BSSID/channel if it matches
+static esp_err_t configure_network(int index) {
+    wifi_config_t wifi_config = {
+        .sta = {
+            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
+        },
+    };
+    strncpy((char *)wifi_config.sta.ssid, s_credentials[index].ssid, sizeof(wifi_config.sta.ssid));
+    strncpy((char *)wifi_config.sta.password, s_credentials[index].password, sizeof(wifi_config.sta.password));
+
+    // After a scan, join the strongest AP of the network (mesh nodes, repeaters)
+    if (s_scanned) {
+        wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+        wifi_config.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
+    }
+
+    s_current_ap = index;
+    s_tried_mask |= 1u << index;
+
+    // Go straight to the last good AP instead of scanning all channels
+    s_fast_connect_attempt = fast_connect_usable();
+    s_static_ip = false;
+    if (s_fast_connect_attempt) {
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, s_fast_connect.bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = s_fast_connect.channel;
+        ESP_LOGI(TAG, "Fast reconnect to " MACSTR " on channel %d",
+                 MAC2STR(s_fast_connect.bssid), s_fast_connect.channel);
+    }
+    return esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+}
+
+// Connect to the best untried network; false if none is left
+static bool connect_next_network(void) {
+    int next = wifi_ap_select_next(&s_ap_cache, WIFI_CREDENTIAL_COUNT, s_tried_mask, s_scanned);
+    if (next < 0 || configure_network(next) != ESP_OK) {
+        return false;
+    }
+
+    s_reconnect_attempt = 0;
+    if (s_ap_cache.rssi[next] != WIFI_AP_RSSI_UNKNOWN) {
+        ESP_LOGI(TAG, "Trying network \"%s\" (RSSI %d)", s_credentials[next].ssid, s_ap_cache.rssi[next]);
+    } else {
+        ESP_LOGI(TAG, "Trying network \"%s\"", s_credentials[next].ssid);
+    }
+    esp_wifi_connect();
+    return true;
+}
+
+// Give up on the current network: scan once per wake to rank the rest, then move on
+static bool switch_network(void) {
+    if (HW_WIFI_RADIO_BUDGET_MS > 0 && radio_on_ms() >= HW_WIFI_RADIO_BUDGET_MS) {
+        return false;
+    }
+    if (wifi_ap_select_next(&s_ap_cache, WIFI_CREDENTIAL_COUNT, s_tried_mask, false) < 0) {
+        return false;
+    }
+
+    if (!s_scanned) {
+        wifi_scan_config_t scan_config = {
+            .show_hidden = true,
+        };
+        if (esp_wifi_scan_start(&scan_config, false) == ESP_OK) {
+            ESP_LOGI(TAG, "Scanning to rank the remaining networks...");
+            s_scan_pending = true;
+            return true;
+        }
+        ESP_LOGW(TAG, "Scan failed, trying networks by cached RSSI");
+    }
+    return connect_next_network();
+}
+
+// Refresh the cached RSSI of every configured network from the scan results
+static void store_scan_results(void) {
+    uint16_t ap_count = 0;
+    esp_wifi_scan_get_ap_num(&ap_count);
+    s_scanned = true;
+    wifi_ap_cache_clear_rssi(&s_ap_cache);
+
+    wifi_ap_record_t *ap_records = (ap_count > 0) ? malloc(sizeof(wifi_ap_record_t) * ap_count) : NULL;
+    if (ap_records == NULL) {
+        esp_wifi_clear_ap_list();
+    } else {
+        if (esp_wifi_scan_get_ap_records(&ap_count, ap_records) == ESP_OK) {
+            for (int i = 0; i < ap_count; i++) {
+                for (int c = 0; c < WIFI_CREDENTIAL_COUNT; c++) {
+                    if (strcmp((char *)ap_records[i].ssid, s_credentials[c].ssid) == 0) {
+                        wifi_ap_cache_update_rssi(&s_ap_cache, c, ap_records[i].rssi);
+                    }
+                }
+            }
+        }
+        free(ap_records);
+    }
+
+    for (int c = 0; c < WIFI_CREDENTIAL_COUNT; c++) {
+        if (s_ap_cache.rssi[c] != WIFI_AP_RSSI_UNKNOWN) {
+            ESP_LOGI(TAG, "  \"%s\": %d dBm", s_credentials[c].ssid, s_ap_cache.rssi[c]);
+        } else {
+            ESP_LOGI(TAG, "  \"%s\": not found", s_credentials[c].ssid);
+        }
+    }
+}
+
 esp_err_t wifi_scan_networks(void) {
     // Initialize NVS
     esp_err_t ret = nvs_flash_init();
@@ -102,9 +446,11 @@ esp_err_t wifi_scan_networks(void) {
                     }
 
                     char marker = ' ';
-                    if (strcmp((char *)ap_records[i].ssid, WIFI_SSID) == 0) {
-                        marker = '*';
-                        found_configured_ssid = true;
+                    for (int c = 0; c < WIFI_CREDENTIAL_COUNT; c++) {
+                        if (strcmp((char *)ap_records[i].ssid, s_credentials[c].ssid) == 0) {
+                            marker = '*';
+                            found_configured_ssid = true;
+                        }
                     }
 
                     ESP_LOGI(TAG, "%c%-31s %-6d %-4d %s",
@@ -116,21 +462,25 @@ esp_err_t wifi_scan_networks(void) {
                 }
 
                 ESP_LOGI(TAG, "");
-                ESP_LOGI(TAG, "Configured SSID: \"%s\"", WIFI_SSID);
-                ESP_LOGI(TAG, "Configured SSID length: %d bytes", strlen(WIFI_SSID));
+                for (int c = 0; c < WIFI_CREDENTIAL_COUNT; c++) {
+                    ESP_LOGI(TAG, "Configured SSID: \"%s\" (%d bytes)",
+                             s_credentials[c].ssid, strlen(s_credentials[c].ssid));
+                }
 
                 if (found_configured_ssid) {
                     ESP_LOGI(TAG, "Status: Configured SSID found in scan (marked with *)");
                 } else {
-                    ESP_LOGW(TAG, "Status: Configured SSID NOT found in scan!");
+                    ESP_LOGW(TAG, "Status: No configured SSID found in scan!");
                     ESP_LOGW(TAG, "This will cause connection to fail with error 201");
 
-                    // Show hex dump of configured SSID for debugging
-                    ESP_LOGW(TAG, "Configured SSID hex: ");
-                    for (int i = 0; i < strlen(WIFI_SSID); i++) {
-                        printf("%02X ", (unsigned char)WIFI_SSID[i]);
+                    // Show hex dump of configured SSIDs for debugging
+                    for (int c = 0; c < WIFI_CREDENTIAL_COUNT; c++) {
+                        ESP_LOGW(TAG, "Configured SSID hex: ");
+                        for (int i = 0; i < strlen(s_credentials[c].ssid); i++) {
+                            printf("%02X ", (unsigned char)s_credentials[c].ssid[i]);
+                        }
+                        printf("\n");
                     }
-                    printf("\n");
                 }
             }
             free(ap_records);
@@ -165,28 +515,99 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
         ESP_LOGI(TAG, "WiFi started, attempting to connect...");
         esp_wifi_connect();
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_SCAN_DONE) {
+        if (!s_scan_pending || s_stopping) {
+            return;
+        }
+        s_scan_pending = false;
+        store_scan_results();
+        if (!connect_next_network()) {
+            ESP_LOGE(TAG, "No other configured network in range, giving up");
+            xEventGroupSetBits(s_wifi_events, WIFI_FAIL_BIT);
+        }
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        // Reuse the cached lease instead of a DHCP exchange
+        if (s_fast_connect_attempt && cached_lease_fresh()) {
+            apply_cached_lease();
+        }
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
         wifi_event_sta_disconnected_t* disconn_evt = (wifi_event_sta_disconnected_t*) event_data;
+        if (s_stopping) {
+            return;
+        }
         ESP_LOGW(TAG, "WiFi disconnected, reason: %d", disconn_evt->reason);
-        // Reason codes:
-        // 2 = AUTH_EXPIRE (password wrong)
-        // 3 = AUTH_LEAVE
-        // 15 = 4WAY_HANDSHAKE_TIMEOUT (password wrong)
-        // 201 = NO_AP_FOUND (SSID wrong or AP not in range)
-        esp_wifi_connect();  // Retry connection
+        s_last_disconnect_reason = disconn_evt->reason;
+        xEventGroupClearBits(s_wifi_events, WIFI_GOT_IP_BIT);
+
+        // Cached AP not reachable: fall back to a full scan and DHCP
+        if (s_fast_connect_attempt) {
+            ESP_LOGW(TAG, "Fast reconnect failed, falling back to full scan and DHCP");
+            s_fast_connect_attempt = false;
+            invalidate_fast_connect();
+
+            esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+            if (s_static_ip && netif != NULL) {
+                esp_netif_dhcpc_start(netif);
+                s_static_ip = false;
+            }
+
+            configure_network(s_current_ap);
+            esp_wifi_connect();
+            return;
+        }
+
+        // Retry with backoff or give up, depending on the reason and the radio budget
+        wifi_reconnect_decision_t decision = wifi_reconnect_decide(disconn_evt->reason, s_reconnect_attempt,
+                                                                   radio_on_ms(), HW_WIFI_RADIO_BUDGET_MS);
+        if (decision.action == WIFI_RECONNECT_GIVE_UP) {
+            // Try the other configured networks before giving up on this wake
+            wifi_ap_cache_record_failure(&s_ap_cache, s_current_ap);
+            if (switch_network()) {
+                return;
+            }
+
+            // Retrying only keeps the radio on; let the waiter give up now
+            ESP_LOGE(TAG, "Giving up on WiFi (reason %d, %d retries, radio on %lu ms)",
+                     disconn_evt->reason, s_reconnect_attempt, (unsigned long)radio_on_ms());
+            xEventGroupSetBits(s_wifi_events, WIFI_FAIL_BIT);
+            return;
+        }
+
+        s_reconnect_attempt++;
+        ESP_LOGI(TAG, "Reconnecting in %lu ms (retry %d)", (unsigned long)decision.backoff_ms, s_reconnect_attempt);
+        if (esp_timer_start_once(s_reconnect_timer, (uint64_t)decision.backoff_ms * 1000) != ESP_OK) {
+            esp_wifi_connect();
+        }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-        ESP_LOGI(TAG, "WiFi connected, IP: " IPSTR, IP2STR(&event->ip_info.ip));
+        ESP_LOGI(TAG, "WiFi connected, IP: " IPSTR "%s", IP2STR(&event->ip_info.ip),
+                 s_static_ip ? " (cached lease)" : "");
+        if (!s_static_ip) {
+            save_fast_connect(&event->ip_info);
+        }
+        // Connected: a later disconnect on this wake (AP reboot, roaming) says nothing about the cache
+        s_fast_connect_attempt = false;
+        wifi_ap_cache_record_success(&s_ap_cache, s_current_ap);
+        xEventGroupSetBits(s_wifi_events, WIFI_GOT_IP_BIT);
     }
 }
 
 esp_err_t wifi_init(void) {
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
+    // NVS is still needed for PHY calibration data; initialize it once per boot
+    static bool nvs_initialized = false;
+    esp_err_t ret;
+    if (!nvs_initialized) {
         ret = nvs_flash_init();
+        if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+            ESP_ERROR_CHECK(nvs_flash_erase());
+            ret = nvs_flash_init();
+        }
+        ESP_ERROR_CHECK(ret);
+        nvs_initialized = true;
     }
-    ESP_ERROR_CHECK(ret);
+
+    // Reuse the stored RF calibration unless it is stale
+    phy_cal_prepare();
 
     // Initialize network interface (only once, reuse if already initialized)
     ret = esp_netif_init();
@@ -205,7 +626,30 @@ esp_err_t wifi_init(void) {
         esp_netif_create_default_wifi_sta();
     }
 
+    // Connection event group (created once, cleared for every connection)
+    if (s_wifi_events == NULL) {
+        s_wifi_events = xEventGroupCreate();
+        if (s_wifi_events == NULL) {
+            ESP_LOGE(TAG, "Failed to create WiFi event group");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    xEventGroupClearBits(s_wifi_events, WIFI_GOT_IP_BIT | WIFI_FAIL_BIT);
+    s_last_disconnect_reason = 0;
+
+    // Delayed reconnects are driven by a one-shot timer
+    if (s_reconnect_timer == NULL) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = reconnect_timer_callback,
+            .name = "wifi_reconnect",
+        };
+        ESP_ERROR_CHECK(esp_timer_create(&timer_args, &s_reconnect_timer));
+    }
+    s_reconnect_attempt = 0;
+    s_stopping = false;
+
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    cfg.nvs_enable = 0;  // Config comes from config.h on every start, don't persist it to flash
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
 
     // Register event handlers only if not already registered
@@ -224,15 +668,20 @@ esp_err_t wifi_init(void) {
                                                             &instance_got_ip));
     }
 
-    wifi_config_t wifi_config = {
-        .sta = {
-            .ssid = WIFI_SSID,
-            .password = WIFI_PASSWORD,
-            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
-        },
-    };
+    // Start with the last good network (no scan), otherwise the strongest cached one
+    if (!s_ap_cache.initialized) {
+        wifi_ap_cache_reset(&s_ap_cache);
+    }
+    s_tried_mask = 0;
+    s_scanned = false;
+    s_scan_pending = false;
+    int first = wifi_ap_select_next(&s_ap_cache, WIFI_CREDENTIAL_COUNT, 0, false);
+    ESP_LOGI(TAG, "Connecting to \"%s\" (%d configured network%s)", s_credentials[first].ssid,
+             WIFI_CREDENTIAL_COUNT, WIFI_CREDENTIAL_COUNT == 1 ? "" : "s");
+
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    ESP_ERROR_CHECK(configure_network(first));
+    s_radio_start_us = esp_timer_get_time();
     ESP_ERROR_CHECK(esp_wifi_start());
 
     ESP_LOGI(TAG, "WiFi initialized");
@@ -240,41 +689,73 @@ esp_err_t wifi_init(void) {
 }
 
 esp_err_t wifi_wait_connected(int max_retries, int retry_delay_ms) {
-    esp_netif_ip_info_t ip_info;
-    int retry_count = 0;
+    int timeout_ms = max_retries * retry_delay_ms;
 
-    ESP_LOGI(TAG, "Waiting for IP address via DHCP (timeout: %d seconds)...",
-             (max_retries * retry_delay_ms) / 1000);
+    if (s_wifi_events == NULL) {
+        ESP_LOGE(TAG, "WiFi not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
 
-    while (retry_count < max_retries) {
-        esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
-        if (netif != NULL && esp_netif_get_ip_info(netif, &ip_info) == ESP_OK) {
-            if (ip_info.ip.addr != 0) {
-                ESP_LOGI(TAG, "Got IP address: " IPSTR, IP2STR(&ip_info.ip));
-                ESP_LOGI(TAG, "Netmask: " IPSTR, IP2STR(&ip_info.netmask));
-                ESP_LOGI(TAG, "Gateway: " IPSTR, IP2STR(&ip_info.gw));
-                return ESP_OK;
-            }
+    // Never wait past the per-wake radio budget
+    if (HW_WIFI_RADIO_BUDGET_MS > 0) {
+        int remaining_ms = (int)HW_WIFI_RADIO_BUDGET_MS - (int)radio_on_ms();
+        if (remaining_ms < timeout_ms) {
+            timeout_ms = (remaining_ms > 0) ? remaining_ms : 0;
         }
+    }
+
+    ESP_LOGI(TAG, "Waiting for IP address via DHCP (timeout: %d seconds)...", timeout_ms / 1000);
 
-        // Log progress every 2 seconds
-        if (retry_count % 4 == 0 && retry_count > 0) {
-            ESP_LOGI(TAG, "Still waiting for IP... (%d/%d)", retry_count, max_retries);
+    // Block until an IP address is assigned, a fatal disconnect occurs or the deadline passes
+    EventBits_t bits = xEventGroupWaitBits(s_wifi_events, WIFI_GOT_IP_BIT | WIFI_FAIL_BIT,
+                                           pdFALSE, pdFALSE, pdMS_TO_TICKS(timeout_ms));
+
+    if (bits & WIFI_GOT_IP_BIT) {
+        esp_netif_ip_info_t ip_info;
+        esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+        if (netif != NULL && esp_netif_get_ip_info(netif, &ip_info) == ESP_OK) {
+            ESP_LOGI(TAG, "Got IP address: " IPSTR, IP2STR(&ip_info.ip));
+            ESP_LOGI(TAG, "Netmask: " IPSTR, IP2STR(&ip_info.netmask));
+            ESP_LOGI(TAG, "Gateway: " IPSTR, IP2STR(&ip_info.gw));
         }
+        s_failed_wakes = 0;
+        return ESP_OK;
+    }
 
-        vTaskDelay(retry_delay_ms / portTICK_PERIOD_MS);
-        retry_count++;
+    // Association or DHCP failed: the cached AP or lease may be the cause
+    s_failed_wakes++;
+    invalidate_fast_connect();
+    if (bits & WIFI_FAIL_BIT) {
+        ESP_LOGE(TAG, "WiFi connection failed (disconnect reason %d), giving up", s_last_disconnect_reason);
+        return ESP_FAIL;
     }
 
-    ESP_LOGE(TAG, "DHCP timeout - no IP address assigned after %d seconds",
-             (max_retries * retry_delay_ms) / 1000);
-    ESP_LOGE(TAG, "WiFi may be connected but DHCP failed");
+    ESP_LOGE(TAG, "DHCP timeout - no IP address assigned after %d seconds", timeout_ms / 1000);
+    if (s_last_disconnect_reason != 0) {
+        ESP_LOGE(TAG, "Last disconnect reason: %d", s_last_disconnect_reason);
+    } else {
+        ESP_LOGE(TAG, "WiFi may be connected but DHCP failed");
+    }
     return ESP_ERR_TIMEOUT;
 }
 
+int wifi_get_last_disconnect_reason(void) {
+    return s_last_disconnect_reason;
+}
+
+uint32_t wifi_get_failed_wake_count(void) {
+    return s_failed_wakes;
+}
+
 esp_err_t wifi_shutdown(void) {
     esp_err_t err;
 
+    // Cancel a pending reconnect; the disconnect caused by stopping is expected
+    s_stopping = true;
+    if (s_reconnect_timer != NULL) {
+        esp_timer_stop(s_reconnect_timer);
+    }
+
     // Stop WiFi
     err = esp_wifi_stop();
     if (err != ESP_OK) {
@@ -0,0 +1,59 @@
+#include "wifi_reconnect_policy.h"
+
+// Reasons that will not fix themselves by retrying within this wake
+static bool is_fatal_reason(int reason) {
+    switch (reason) {
+        case WIFI_RECONNECT_REASON_AUTH_EXPIRE:            // Password wrong
+        case WIFI_RECONNECT_REASON_4WAY_HANDSHAKE_TIMEOUT: // Password wrong
+        case WIFI_RECONNECT_REASON_AUTH_FAIL:
+        case WIFI_RECONNECT_REASON_HANDSHAKE_TIMEOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+wifi_reconnect_decision_t wifi_reconnect_decide(int reason, int attempt,
+                                                uint32_t radio_on_ms, uint32_t budget_ms) {
+    wifi_reconnect_decision_t decision = {WIFI_RECONNECT_GIVE_UP, 0};
+
+    if (attempt < 0) {
+        attempt = 0;
+    }
+
+    if (is_fatal_reason(reason)) {
+        return decision;
+    }
+
+    int max_attempts = (reason == WIFI_RECONNECT_REASON_NO_AP_FOUND)
+                           ? WIFI_RECONNECT_NO_AP_ATTEMPTS
+                           : WIFI_RECONNECT_MAX_ATTEMPTS;
+    if (attempt >= max_attempts) {
+        return decision;
+    }
+
+    // Exponential backoff: base, 2x base, 4x base, ... capped
+    uint32_t backoff_ms = WIFI_RECONNECT_BASE_BACKOFF_MS;
+    for (int i = 0; i < attempt && backoff_ms < WIFI_RECONNECT_MAX_BACKOFF_MS; i++) {
+        backoff_ms *= 2;
+    }
+    if (backoff_ms > WIFI_RECONNECT_MAX_BACKOFF_MS) {
+        backoff_ms = WIFI_RECONNECT_MAX_BACKOFF_MS;
+    }
+
+    // Don't start an attempt that would end past the radio budget
+    if (budget_ms > 0 && radio_on_ms + backoff_ms >= budget_ms) {
+        return decision;
+    }
+
+    decision.action = WIFI_RECONNECT_RETRY;
+    decision.backoff_ms = backoff_ms;
+    return decision;
+}
+
+bool wifi_reconnect_wake_allowed(uint32_t failed_wakes, uint32_t max_failed_wakes, bool required) {
+    if (required || max_failed_wakes == 0) {
+        return true;
+    }
+    return failed_wakes < max_failed_wakes;
+}
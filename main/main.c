@@ -4,23 +4,33 @@
 #include <sys/time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "esp_system.h"
 #include "esp_log.h"
 #include "esp_sleep.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
 #include "driver/rtc_io.h"
 
 // Include shared components
 #include "rtc_helper.h"
 #include "timezone_helper.h"
+#include "clock_service.h"
 #include "led_gpio.h"
 #include "cloudcover_leds.h"
 #include "rgb_led_control.h"
 #include "weather_fetch.h"
 #include "wifi_helper.h"
+#include "wifi_reconnect_policy.h"
 #include "config_print.h"
 #include "hardware_config.h"
 #include "remote_logging.h"
 #include "weather_diagnostics.h"
+#include "wake_profiler.h"
+#include "power_profile.h"
+#include "wake_scheduler.h"
+#include "network_policy.h"
+#include "sleep_drift.h"
 
 // WiFi credentials and location override come from config.h (in hardware_config component)
 // This file is gitignored and must be created from config.h.example
@@ -51,13 +61,66 @@ static const char *TAG = "WEATHER_CONTROL";
 #define I2C_MASTER_SCL_IO HW_I2C_SCL_PIN
 
 #define WEATHER_CHECK_HOUR HW_WEATHER_CHECK_HOUR
+#define PIN_ON_HOUR HW_PIN_ON_HOUR
+
+// The DS3231 alarm fires exactly on the hour; the internal timer needs a buffer
+#if HW_RTC_ALARM_WAKE_ENABLED
+    #define WAKE_TARGET_SECOND 0
+#else
+    #define WAKE_TARGET_SECOND HW_WAKE_TARGET_SECOND
+#endif
+#define RTC_INT_PIN HW_RTC_INT_PIN
 
 // RTC memory variables persist during deep sleep
 RTC_DATA_ATTR int pin_off_hour = 17;  // Default to 5 PM if no weather data
 RTC_DATA_ATTR bool weather_fetched = false;
 RTC_DATA_ATTR float current_cloud_cover = 75.0f;  // Default to cloudy (0 LEDs)
+RTC_DATA_ATTR int forecast_led_count = 0;  // Cloudcover LEDs for the current forecast
 RTC_DATA_ATTR bool last_pin_state = false;  // Track previous pin state for edge detection
 RTC_DATA_ATTR bool rgb_led_initialized = false;  // Track RGB LED initialization state
+RTC_DATA_ATTR bool outputs_applied = false;  // Pin, LEDs and RGB LED below are latched (reset on cold boot)
+RTC_DATA_ATTR int applied_led_count = 0;  // Cloudcover LEDs currently lit and held
+RTC_DATA_ATTR time_t last_log_upload_epoch = 0;  // UTC epoch of last successful log flush (0 = never)
+RTC_DATA_ATTR uint32_t planned_wake_events = 0;  // WAKE_EVENT_* bits this wake was scheduled for
+RTC_DATA_ATTR sleep_drift_t sleep_drift = {0};  // Learned deep sleep timer drift
+RTC_DATA_ATTR int64_t sleep_requested_us = 0;  // Duration passed to the sleep timer (0 = none)
+RTC_DATA_ATTR int64_t sleep_started_utc_us = 0;  // UTC time (microseconds) when deep sleep started
+
+_Static_assert(sizeof(pin_off_hour) + sizeof(weather_fetched) + sizeof(current_cloud_cover) +
+               sizeof(forecast_led_count) + sizeof(last_pin_state) + sizeof(rgb_led_initialized) +
+               sizeof(outputs_applied) + sizeof(applied_led_count) + sizeof(last_log_upload_epoch) +
+               sizeof(planned_wake_events) + sizeof(sleep_drift) + sizeof(sleep_requested_us) +
+               sizeof(sleep_started_utc_us) <= HW_RTC_BUDGET_MAIN,
+               "RTC variables of main exceed HW_RTC_BUDGET_MAIN");
+
+static time_t sleep_target_epoch = 0;  // UTC epoch of the next wake (0 = unknown)
+
+// Network stage tasks and their join bits
+#define STAGE_WIFI_DONE  BIT0
+#define STAGE_FETCH_DONE BIT1
+#define STAGE_FLUSH_DONE BIT2
+
+// Core 0 also runs the WiFi driver task; TLS and JSON work goes to core 1
+#define STAGE_CORE_NETWORK 1
+#define STAGE_CORE_UPLOAD  0
+
+// The fetch task runs the full TLS handshake (certificate bundle verification) and
+// the diagnostics upload; its unused stack is reported with the wake profile
+#define STAGE_STACK_WIFI  4096
+#define STAGE_STACK_FETCH 8192
+#define STAGE_STACK_FLUSH 4096
+
+typedef struct {
+    void (*run)(void);
+    EventBits_t done_bit;
+    uint32_t stack_size;
+    wake_phase_t phase;          // Phase the task's stack high-water mark is reported under
+} stage_t;
+
+static EventGroupHandle_t stage_events = NULL;
+static bool wifi_started = false;
+static bool wifi_connected = false;
+static esp_err_t flush_result = ESP_OK;
 
 // Find appropriate pin-off hour based on cloudcover percentage
 static int get_pin_off_hour_from_cloudcover(float cloudcover) {
@@ -94,18 +157,18 @@ static int get_pin_off_hour_from_cloudcover(float cloudcover) {
     return 17;
 }
 
-// Wait until the clock reaches HH:00:30 to compensate for deep sleep timer inaccuracy
+// Wait (in light sleep) until the clock reaches HH:00:30 to absorb leftover deep sleep timer error
 static void wait_until_target_second(void) {
-    datetime_t utc_time, local_time;
+    datetime_t local_time;
 
-    // Read current time
-    if (rtc_read_time(&utc_time) != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to read RTC time for synchronization");
+    // Woken by the DS3231 alarm: already exactly on time
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0) {
+        ESP_LOGI(TAG, "Woken by RTC alarm, no wait needed");
         return;
     }
 
-    if (utc_to_local(&utc_time, &local_time) != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to convert time for synchronization");
+    if (clock_now_local(&local_time) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to get time for synchronization");
         return;
     }
 
@@ -115,7 +178,7 @@ static void wait_until_target_second(void) {
     // Only wait if minute is 0 or >= 58 (within ~2 minutes of target hour)
     if (local_time.minute == 0 || local_time.minute >= 58) {
         // Calculate seconds until HH:00:30
-        int target_second = 30;
+        int target_second = WAKE_TARGET_SECOND;
         int seconds_to_wait = 0;
 
         if (local_time.minute >= 58) {
@@ -137,18 +200,16 @@ static void wait_until_target_second(void) {
         }
 
         if (seconds_to_wait > 0) {
-            ESP_LOGI(TAG, "Waiting %d seconds until %02d:00:30",
-                     seconds_to_wait, (local_time.minute >= 58) ? (local_time.hour + 1) % 24 : local_time.hour);
-
-            // Wait in small increments for better responsiveness
-            while (seconds_to_wait > 0) {
-                int delay_ms = (seconds_to_wait > 1) ? 1000 : (seconds_to_wait * 1000);
-                vTaskDelay(pdMS_TO_TICKS(delay_ms));
-                seconds_to_wait--;
-            }
+            ESP_LOGI(TAG, "Waiting %d seconds until %02d:00:%02d",
+                     seconds_to_wait, (local_time.minute >= 58) ? (local_time.hour + 1) % 24 : local_time.hour,
+                     target_second);
+
+            // Light sleep for the remaining time instead of keeping the CPU awake
+            esp_sleep_enable_timer_wakeup((uint64_t)seconds_to_wait * 1000000ULL);
+            esp_light_sleep_start();
 
             // Verify we reached the target time
-            if (rtc_read_time(&utc_time) == ESP_OK && utc_to_local(&utc_time, &local_time) == ESP_OK) {
+            if (clock_now_local(&local_time) == ESP_OK) {
                 ESP_LOGI(TAG, "Target time reached: %02d:%02d:%02d",
                          local_time.hour, local_time.minute, local_time.second);
             }
@@ -159,33 +220,162 @@ static void wait_until_target_second(void) {
     }
 }
 
-void fetch_weather_forecast_and_update(void) {
+#if HW_RTC_ALARM_WAKE_ENABLED
+// Program DS3231 Alarm 1 for the next wake and arm ext0 wakeup on its INT/SQW pin
+static bool arm_rtc_alarm_wakeup(time_t target_epoch) {
+    datetime_t alarm_utc;
+    if (target_epoch <= 0 || epoch_to_datetime(target_epoch, &alarm_utc) != ESP_OK) {
+        return false;
+    }
+
+    if (rtc_set_alarm1(&alarm_utc) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set RTC alarm, falling back to sleep timer");
+        return false;
+    }
+
+    // INT/SQW is open-drain: pull it up and wake when the alarm drives it low
+    rtc_gpio_init(RTC_INT_PIN);
+    rtc_gpio_set_direction(RTC_INT_PIN, RTC_GPIO_MODE_INPUT_ONLY);
+    rtc_gpio_pulldown_dis(RTC_INT_PIN);
+    rtc_gpio_pullup_en(RTC_INT_PIN);
+    if (esp_sleep_enable_ext0_wakeup(RTC_INT_PIN, 0) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to enable ext0 wakeup on GPIO %d, falling back to sleep timer", RTC_INT_PIN);
+        rtc_disable_alarm1();
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+// Compare the last requested deep sleep with the DS3231 and update the drift estimate
+static void update_sleep_drift(void) {
+    if (sleep_requested_us <= 0) {
+        return;
+    }
+
+    int64_t requested_us = sleep_requested_us;
+    sleep_requested_us = 0;
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER) {
+        return;
+    }
+
+    if (!clock_service_is_valid()) {
+        return;
+    }
+
+    // esp_timer counts from boot, so subtract it to get the moment of wakeup
+    int64_t actual_us = (clock_now_utc_us() - esp_timer_get_time()) - sleep_started_utc_us;
+
+    if (sleep_drift_update(&sleep_drift, requested_us, actual_us)) {
+        ESP_LOGI(TAG, "Sleep drift: requested %lld s, measured %lld s -> estimate %ld ppm (%lu samples)",
+                 requested_us / 1000000LL, actual_us / 1000000LL,
+                 (long)sleep_drift.drift_ppm, (unsigned long)sleep_drift.samples);
+    } else {
+        ESP_LOGW(TAG, "Sleep drift sample rejected (requested %lld s, measured %lld s)",
+                 requested_us / 1000000LL, actual_us / 1000000LL);
+    }
+}
+
+// Take over a forecast for tomorrow (fetched or cached) and return the LED count
+static int apply_forecast(const weather_data_t *weather_data) {
+    current_cloud_cover = weather_data->tomorrow_cloudcover;
+    if (weather_data->server_decision) {
+        pin_off_hour = weather_data->decision_pin_off_hour;
+        forecast_led_count = weather_data->decision_led_count;
+    } else {
+        pin_off_hour = get_pin_off_hour_from_cloudcover(weather_data->tomorrow_cloudcover);
+        forecast_led_count = led_count_from_cloudcover(weather_data->tomorrow_cloudcover);
+    }
+    ESP_LOGI(TAG, "Tomorrow cloud cover: %.1f%%%s -> pin will turn off at %d:00, LEDs: %d",
+            weather_data->tomorrow_cloudcover,
+            weather_data->from_cache ? " (cached)" : weather_data->server_decision ? " (server decision)" : "",
+            pin_off_hour, forecast_led_count);
+    return forecast_led_count;
+}
+
+// Fetch tomorrow's forecast (the cache stands in if the download fails); true if one was applied
+bool fetch_weather_forecast_and_update(void) {
     ESP_LOGI(TAG, "Starting weather fetch");
 
     weather_data_t weather_data;
     if (fetch_weather_forecast(LATITUDE, LONGITUDE, &weather_data) == ESP_OK && weather_data.valid) {
-        current_cloud_cover = weather_data.tomorrow_cloudcover;
-        pin_off_hour = get_pin_off_hour_from_cloudcover(weather_data.tomorrow_cloudcover);
-        int led_count = led_count_from_cloudcover(weather_data.tomorrow_cloudcover);
-        ESP_LOGI(TAG, "Tomorrow cloud cover: %.1f%% -> pin will turn off at %d:00, LEDs: %d",
-                weather_data.tomorrow_cloudcover, pin_off_hour, led_count);
+        int led_count = apply_forecast(&weather_data);
 
-        // Send diagnostic data to server
+        // Send diagnostic data to server (includes wake profile statistics)
         if (send_weather_diagnostics(&weather_data, pin_off_hour, led_count) == ESP_OK) {
             ESP_LOGI(TAG, "Weather diagnostics sent successfully");
+            wake_profiler_reset();
+            power_profile_reset();
         } else {
             ESP_LOGW(TAG, "Failed to send weather diagnostics");
         }
-    } else {
-        ESP_LOGE(TAG, "Failed to fetch valid weather data");
+        return true;
     }
+
+    ESP_LOGE(TAG, "Failed to fetch valid weather data");
+    return false;
 }
 
-void control_gpio(const datetime_t *local_time) {
+// Use tomorrow's forecast from the RTC forecast cache (max_age_hours 0 = any age)
+static bool use_cached_forecast(int max_age_hours) {
+    weather_data_t weather_data;
+    if (weather_forecast_from_cache(max_age_hours, &weather_data) != ESP_OK || !weather_data.valid) {
+        return false;
+    }
+    apply_forecast(&weather_data);
+    return true;
+}
+
+// Set the RGB LED, initializing the RMT driver on first use in this wake
+static void rgb_led_update(bool on) {
+    static bool rgb_ready = false;
+
+    // Clear LED only on first boot (!rgb_led_initialized = true)
+    // Preserve LED state on wakeups (!rgb_led_initialized = false)
+    if (!rgb_ready) {
+        wake_profiler_begin(WAKE_PHASE_RGB_LED_INIT);
+        rgb_ready = (rgb_led_init(!rgb_led_initialized) == ESP_OK);
+        rgb_led_initialized = rgb_ready;
+        wake_profiler_end(WAKE_PHASE_RGB_LED_INIT);
+        if (rgb_ready) {
+            ESP_LOGI(TAG, "RGB LED initialized");
+        }
+    }
+
+    if (rgb_ready) {
+        rgb_led_set_state(on);
+    }
+}
+
+// Drive the cloudcover LEDs for the cached forecast; only rewritten when the lit count changes
+static void update_led_display(bool pin_active, bool force) {
     static const gpio_num_t led_pins[NUM_LEDS] = HW_LED_PINS;
 
+    // Control LEDs - only show if weather has been fetched AND main pin is active
+    bool show_leds = weather_fetched && pin_active;
+    int led_count = show_leds ? forecast_led_count : 0;
+    if (led_count > NUM_LEDS) {
+        led_count = NUM_LEDS;
+    }
+
+    // LEDs are held by rtc_gpio_hold_en across deep sleep, so an unchanged display needs no rewrite
+    if (!force && led_count == applied_led_count) {
+        ESP_LOGI(TAG, "LED display unchanged (%d LEDs)", led_count);
+        return;
+    }
+
+    ESP_LOGI(TAG, "LED control: main_pin=%s, cloudcover=%.1f%%, active_leds=%d",
+             pin_active ? "ON" : "OFF", current_cloud_cover, led_count);
+    control_led_count(led_pins, NUM_LEDS, led_count);
+    applied_led_count = led_count;
+}
+
+void control_gpio(const datetime_t *local_time) {
     int hour = local_time->hour;
-    bool activate = (hour >= 9 && hour < pin_off_hour);
+    wake_schedule_t schedule = {.pin_on_hour = PIN_ON_HOUR, .pin_off_hour = pin_off_hour};
+    bool activate = wake_scheduler_pin_active(&schedule, hour);
+    bool pin_changed = !outputs_applied || activate != last_pin_state;
 
     // Detect pin turning off (transition from ON to OFF)
     if (last_pin_state && !activate) {
@@ -197,66 +387,250 @@ void control_gpio(const datetime_t *local_time) {
     ESP_LOGI(TAG, "GPIO control: hour=%d, pin_off_hour=%d, activate=%s, weather_fetched=%s",
              hour, pin_off_hour, activate ? "yes" : "no", weather_fetched ? "yes" : "no");
 
-    // Control main GPIO pin
-    set_rtc_gpio_output(GPIO_CONTROL_PIN, activate ? 1 : 0);
+    // The pin is held by rtc_gpio_hold_en (and the RGB LED keeps its color) across
+    // deep sleep, so nothing needs rewriting when the wanted state has not changed
+    if (pin_changed) {
+        // Control main GPIO pin
+        set_rtc_gpio_output(GPIO_CONTROL_PIN, activate ? 1 : 0);
 
-    // Control RGB LED to mirror GPIO control pin state
-    rgb_led_set_state(activate);
+        // Control RGB LED to mirror GPIO control pin state
+        rgb_led_update(activate);
+    } else {
+        ESP_LOGI(TAG, "Control pin unchanged (%s), kept by RTC GPIO hold", activate ? "ON" : "OFF");
+    }
 
-    // Control LEDs - only show if weather has been fetched AND main pin is active
-    bool show_leds = weather_fetched && activate;
-    control_leds(led_pins, NUM_LEDS, show_leds, current_cloud_cover);
+    update_led_display(activate, !outputs_applied);
+    outputs_applied = true;
+}
+
+// Hours from now until the remote log upload deadline (0 = no deadline)
+static int log_upload_due_hours(time_t now_epoch) {
+    if (HW_LOG_UPLOAD_INTERVAL_HOURS <= 0) {
+        return 0;
+    }
+
+    long remaining = (long)HW_LOG_UPLOAD_INTERVAL_HOURS * 3600;
+    if (last_log_upload_epoch > 0 && now_epoch > last_log_upload_epoch) {
+        remaining -= (long)(now_epoch - last_log_upload_epoch);
+    }
+
+    int hours = (int)((remaining + 3599) / 3600);
+    return (hours < 1) ? 1 : hours;
+}
+
+// Calculate deep sleep duration until the next scheduled event at HH:00:30 local time
+static int calculate_sleep_seconds(void) {
+    int sleep_seconds = 3600; // Default 1 hour fallback
+    datetime_t current_local;
+    sleep_target_epoch = 0;
+    planned_wake_events = WAKE_EVENT_NONE;
+    if (clock_now_local(&current_local) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to get time for sleep calculation, using default 1 hour");
+        return sleep_seconds;
+    }
+    time_t now_epoch = clock_now_epoch();
+
+    wake_schedule_t schedule = {
+        .pin_on_hour = PIN_ON_HOUR,
+        .pin_off_hour = pin_off_hour,
+        .weather_check_hour = WEATHER_CHECK_HOUR,
+        .log_upload_due_hours = log_upload_due_hours(now_epoch),
+        // A wake only for the upload would skip WiFi after repeated failed connects
+        .uploads_blocked = !wifi_reconnect_wake_allowed(wifi_get_failed_wake_count(),
+                                                        HW_WIFI_MAX_FAILED_WAKES, false),
+    };
+    wake_plan_t plan;
+    wake_scheduler_next(&schedule, current_local.hour, &plan);
+    planned_wake_events = plan.events;
+
+    // Target HH:00:30 local; local_to_utc() normalizes day rollover and DST changes
+    datetime_t target_local = current_local;
+    target_local.hour += plan.hours_ahead;
+    target_local.minute = 0;
+    target_local.second = WAKE_TARGET_SECOND;
+
+    datetime_t target_utc;
+    time_t target_epoch;
+    if (local_to_utc(&target_local, &target_utc) == ESP_OK &&
+        datetime_to_epoch(&target_utc, &target_epoch) == ESP_OK &&
+        target_epoch > now_epoch) {
+        sleep_seconds = (int)(target_epoch - now_epoch);
+        sleep_target_epoch = target_epoch;
+    } else {
+        int seconds_into_hour = current_local.minute * 60 + current_local.second;
+        sleep_seconds = (plan.hours_ahead * 3600) - seconds_into_hour + WAKE_TARGET_SECOND;
+    }
+
+    char events[64];
+    ESP_LOGI(TAG, "Current time: %02d:%02d:%02d, next wake %02d:00:%02d (%s), sleeping for %d seconds",
+             current_local.hour, current_local.minute, current_local.second,
+             plan.hour, WAKE_TARGET_SECOND,
+             wake_scheduler_describe(plan.events, events, sizeof(events)),
+             sleep_seconds);
+
+    return sleep_seconds;
+}
+
+// Network stage: bring WiFi up and wait for an IP address
+static void wifi_connect_stage(void) {
+    wake_profiler_begin(WAKE_PHASE_WIFI_INIT);
+    esp_err_t wifi_err = wifi_init();
+    wake_profiler_end(WAKE_PHASE_WIFI_INIT);
+    if (wifi_err != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi init failed");
+        return;
+    }
+
+    wifi_started = true;
+    wake_profiler_begin(WAKE_PHASE_WIFI_WAIT_CONNECTED);
+    if (wifi_wait_connected(20, 500) == ESP_OK) {
+        wifi_connected = true;
+    } else {
+        ESP_LOGE(TAG, "WiFi connection failed");
+    }
+    wake_profiler_end(WAKE_PHASE_WIFI_WAIT_CONNECTED);
+}
+
+// Network stage: fetch the forecast and send diagnostics
+static void fetch_stage(void) {
+    wake_profiler_begin(WAKE_PHASE_FETCH);
+    // Only a forecast that was applied (fresh or cached) counts; otherwise the LEDs stay off
+    if (fetch_weather_forecast_and_update()) {
+        weather_fetched = true;
+    }
+    wake_profiler_end(WAKE_PHASE_FETCH);
+}
+
+// Network stage: upload buffered logs
+static void flush_stage(void) {
+    int buffered = remote_logging_get_buffered_count();
+    int dropped = remote_logging_get_dropped_count();
+    flush_result = ESP_OK;
+    if (buffered == 0 && dropped == 0) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "Flushing %d buffered logs (dropped: %d) to remote server", buffered, dropped);
+    wake_profiler_begin(WAKE_PHASE_FLUSH);
+    flush_result = remote_logging_flush();
+    wake_profiler_end(WAKE_PHASE_FLUSH);
+    if (flush_result == ESP_OK) {
+        ESP_LOGI(TAG, "Remote log flush successful");
+    } else {
+        ESP_LOGW(TAG, "Remote log flush failed, logs will be retried next time");
+    }
+}
+
+static const stage_t WIFI_STAGE = {wifi_connect_stage, STAGE_WIFI_DONE, STAGE_STACK_WIFI, WAKE_PHASE_WIFI_INIT};
+static const stage_t FETCH_STAGE = {fetch_stage, STAGE_FETCH_DONE, STAGE_STACK_FETCH, WAKE_PHASE_FETCH};
+static const stage_t FLUSH_STAGE = {flush_stage, STAGE_FLUSH_DONE, STAGE_STACK_FLUSH, WAKE_PHASE_FLUSH};
+
+static void stage_task(void *arg) {
+    const stage_t *stage = (const stage_t *)arg;
+    stage->run();
+    wake_profiler_stack(stage->phase, stage->stack_size, uxTaskGetStackHighWaterMark(NULL));
+    xEventGroupSetBits(stage_events, stage->done_bit);
+    vTaskDelete(NULL);
+}
+
+// Run a stage as a task pinned to a core, or inline if the task cannot be created
+static void start_stage(const stage_t *stage, const char *name, BaseType_t core) {
+    if (xTaskCreatePinnedToCore(stage_task, name, stage->stack_size, (void *)stage, 5, NULL, core) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to start %s task, running inline", name);
+        stage->run();
+        xEventGroupSetBits(stage_events, stage->done_bit);
+    }
+}
+
+static void wait_stages(EventBits_t bits) {
+    xEventGroupWaitBits(stage_events, bits, pdFALSE, pdTRUE, portMAX_DELAY);
 }
 
 void app_main(void) {
+    // Deep sleep wakes take the warm path; power-on and resets take the cold path
+    esp_sleep_wakeup_cause_t wakeup_cause = esp_sleep_get_wakeup_cause();
+    bool warm_boot = (wakeup_cause != ESP_SLEEP_WAKEUP_UNDEFINED);
+
     ESP_LOGI(TAG, "Weather Triggered Pin Control starting");
 
+    // Low CPU frequency and automatic light sleep while waiting
+    power_profile_init();
+
     // Initialize timezone for DST support
+    wake_profiler_begin(WAKE_PHASE_TIMEZONE_INIT);
     if (timezone_init() != ESP_OK) {
         ESP_LOGE(TAG, "Timezone initialization failed");
     }
+    wake_profiler_end(WAKE_PHASE_TIMEZONE_INIT);
 
     // Initialize I2C for RTC first (needed for timestamps in remote logging)
+    wake_profiler_begin(WAKE_PHASE_RTC_I2C_INIT);
     if (rtc_i2c_init(I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO) != ESP_OK) {
         ESP_LOGE(TAG, "I2C initialization failed, restarting");
         esp_restart();
     }
 
+    // Read the DS3231 once; all later time queries are served from esp_timer
+    if (clock_service_init() != ESP_OK) {
+        ESP_LOGE(TAG, "RTC read failed, restarting");
+        esp_restart();
+    }
+    wake_profiler_end(WAKE_PHASE_RTC_I2C_INIT);
+
+    // Learn how far the deep sleep timer drifted on the last sleep
+    update_sleep_drift();
+
+#if HW_RTC_ALARM_WAKE_ENABLED
+    // Release INT/SQW so the next alarm can pull it low again
+    bool alarm_fired = false;
+    if (rtc_clear_alarm1_flag(&alarm_fired) == ESP_OK && alarm_fired) {
+        ESP_LOGI(TAG, "RTC alarm flag cleared");
+    }
+#endif
+
     // Initialize remote logging (buffers logs for sending to HTTP server)
+    wake_profiler_begin(WAKE_PHASE_REMOTE_LOGGING_INIT);
     if (remote_logging_init() == ESP_OK) {
         ESP_LOGI(TAG, "Remote logging initialized");
     }
+    wake_profiler_end(WAKE_PHASE_REMOTE_LOGGING_INIT);
 
-    // Initialize RGB LED (optional feature, configured in hardware_config.h)
-    // Always initialize (RMT peripheral needs setup after deep sleep)
-    // Clear LED only on first boot (!rgb_led_initialized = true)
-    // Preserve LED state on wakeups (!rgb_led_initialized = false)
-    rgb_led_initialized = (rgb_led_init(!rgb_led_initialized) == ESP_OK);
-    if (rgb_led_initialized) {
-        ESP_LOGI(TAG, "RGB LED initialized");
-    }
+    // RGB LED (optional feature, configured in hardware_config.h) is initialized
+    // lazily in control_gpio(), only when its state has to change
 
-    // Log cloudcover configuration ranges
-    ESP_LOGI(TAG, "Cloudcover ranges configuration:");
-    for (int i = 0; i < HW_NUM_CLOUDCOVER_RANGES; i++) {
-        ESP_LOGI(TAG, "  Range %d: [%.1f%%, %.1f%%) -> pin off at %d:00",
-                 i + 1,
-                 HW_CLOUDCOVER_RANGES[i].min_cloudcover,
-                 HW_CLOUDCOVER_RANGES[i].max_cloudcover,
-                 HW_CLOUDCOVER_RANGES[i].pin_high_until_hour);
-    }
+    if (warm_boot) {
+        ESP_LOGI(TAG, "Warm boot (wakeup cause %d), outputs %s",
+                 (int)wakeup_cause, outputs_applied ? "held from last wake" : "not yet applied");
+    } else {
+        // Outputs held by RTC GPIO hold are only trusted after a deep sleep wake
+        outputs_applied = false;
 
-    // Read UTC time from RTC
-    datetime_t utc_time;
-    if (rtc_read_time(&utc_time) != ESP_OK) {
-        ESP_LOGE(TAG, "RTC read failed, restarting");
-        esp_restart();
+#if !HW_RTC_ALARM_WAKE_ENABLED
+        // An alarm armed by a build with alarm wake enabled would keep pulling INT/SQW low
+        rtc_disable_alarm1();
+#endif
+
+        // Log cloudcover configuration ranges
+        ESP_LOGI(TAG, "Cloudcover ranges configuration:");
+        for (int i = 0; i < HW_NUM_CLOUDCOVER_RANGES; i++) {
+            ESP_LOGI(TAG, "  Range %d: [%.1f%%, %.1f%%) -> pin off at %d:00",
+                     i + 1,
+                     HW_CLOUDCOVER_RANGES[i].min_cloudcover,
+                     HW_CLOUDCOVER_RANGES[i].max_cloudcover,
+                     HW_CLOUDCOVER_RANGES[i].pin_high_until_hour);
+        }
     }
 
-    // Convert UTC to local time (CET/CEST with automatic DST)
-    datetime_t local_time;
-    if (utc_to_local(&utc_time, &local_time) != ESP_OK) {
-        ESP_LOGE(TAG, "Timezone conversion failed, restarting");
+    // Wait until HH:00:30 to compensate for deep sleep timer inaccuracy
+    // (before reading the time below, so an early wake acts on the target hour)
+    wake_profiler_begin(WAKE_PHASE_WAIT_TARGET_SECOND);
+    wait_until_target_second();
+    wake_profiler_end(WAKE_PHASE_WAIT_TARGET_SECOND);
+
+    // Current UTC and local time (CET/CEST with automatic DST) from the clock service
+    datetime_t utc_time, local_time;
+    if (clock_now_utc(&utc_time) != ESP_OK || clock_now_local(&local_time) != ESP_OK) {
+        ESP_LOGE(TAG, "Clock read failed, restarting");
         esp_restart();
     }
 
@@ -273,67 +647,143 @@ void app_main(void) {
     ESP_LOGI(TAG, "Current pin-off hour setting: %d:00 (weather fetched: %s)",
              pin_off_hour, weather_fetched ? "yes" : "no");
     ESP_LOGI(TAG, "Current cloud cover: %.1f%% -> %d LEDs active",
-             current_cloud_cover, led_count_from_cloudcover(current_cloud_cover));
+             current_cloud_cover, forecast_led_count);
 
-    // Wait until HH:00:30 to compensate for deep sleep timer inaccuracy
-    wait_until_target_second();
+    // Decide on WiFi first so association can overlap with the local stage
+    time_t now_epoch = clock_now_epoch();
+    bool weather_fetch_due = (local_time.hour == WEATHER_CHECK_HOUR && !weather_fetched);
 
-    // Enable WiFi every hour for remote logging (and weather fetch at 4 PM)
-    ESP_LOGI(TAG, "Initializing WiFi");
-    bool wifi_connected = false;
-    if (wifi_init() == ESP_OK) {
-        if (wifi_wait_connected(20, 500) == ESP_OK) {
-            wifi_connected = true;
-        } else {
-            ESP_LOGE(TAG, "WiFi connection failed");
+    // Tomorrow is still in the forecast cache from a recent fetch: no WiFi needed for it
+    if (weather_fetch_due && HW_FORECAST_CACHE_MAX_AGE_HOURS > 0 &&
+        use_cached_forecast(HW_FORECAST_CACHE_MAX_AGE_HOURS)) {
+        weather_fetched = true;
+        weather_fetch_due = false;
+    }
+    network_policy_input_t policy_input = {
+        .weather_fetch_due = weather_fetch_due,
+        .buffered_logs = remote_logging_get_buffered_count(),
+        .log_high_water = HW_LOG_FLUSH_HIGH_WATER,
+        .has_error_logs = remote_logging_has_errors(),
+        .seconds_since_upload = (last_log_upload_epoch > 0) ? (long)(now_epoch - last_log_upload_epoch) : -1,
+        .max_staleness_seconds = (long)HW_LOG_UPLOAD_INTERVAL_HOURS * 3600,
+        .upload_wake = warm_boot && (planned_wake_events & WAKE_EVENT_LOG_UPLOAD),
+    };
+    uint32_t network_reasons = network_policy_evaluate(&policy_input);
+    char reasons_str[64];
+    network_policy_describe(network_reasons, reasons_str, sizeof(reasons_str));
+
+    bool network_stage = (network_reasons != NETWORK_REASON_NONE);
+
+    // After repeated failed connects, only the weather fetch is worth the radio time
+    if (network_stage &&
+        !wifi_reconnect_wake_allowed(wifi_get_failed_wake_count(), HW_WIFI_MAX_FAILED_WAKES, weather_fetch_due)) {
+        ESP_LOGW(TAG, "Skipping WiFi (reason: %s): %lu wakes in a row failed to connect",
+                 reasons_str, (unsigned long)wifi_get_failed_wake_count());
+        network_stage = false;
+    }
+
+    if (network_stage) {
+        stage_events = xEventGroupCreate();
+        if (stage_events == NULL) {
+            ESP_LOGE(TAG, "Failed to create stage event group, skipping WiFi");
+            network_stage = false;
         }
-    } else {
-        ESP_LOGE(TAG, "WiFi init failed");
     }
 
-    // Fetch weather at 4 PM local time if WiFi is connected
-    if (wifi_connected && local_time.hour == WEATHER_CHECK_HOUR && !weather_fetched) {
-        fetch_weather_forecast_and_update();
-        weather_fetched = true;
+    if (network_stage) {
+        ESP_LOGI(TAG, "Initializing WiFi (reason: %s)", reasons_str);
+        start_stage(&WIFI_STAGE, "wifi_connect", STAGE_CORE_NETWORK);
+    } else if (network_reasons == NETWORK_REASON_NONE) {
+        ESP_LOGI(TAG, "Skipping WiFi: nothing to fetch, %d buffered logs kept for a later upload",
+                 policy_input.buffered_logs);
     }
 
-    // Control GPIO and LEDs based on weather and local time
+    // Local stage: drive pin, LEDs and RGB LED from cached RTC state right at the
+    // hour boundary, without waiting for (or depending on) the network
+    wake_profiler_begin(WAKE_PHASE_CONTROL_GPIO);
     control_gpio(&local_time);
+    wake_profiler_end(WAKE_PHASE_CONTROL_GPIO);
 
-    // Calculate sleep duration to wake at next full hour + 30 seconds
-    int sleep_seconds = 3600; // Default 1 hour fallback
-    datetime_t current_utc, current_local;
-    if (rtc_read_time(&current_utc) == ESP_OK && utc_to_local(&current_utc, &current_local) == ESP_OK) {
-        int seconds_into_hour = current_local.minute * 60 + current_local.second;
-        int seconds_until_next_hour = 3600 - seconds_into_hour;
-        sleep_seconds = seconds_until_next_hour + 30; // Add 30s buffer
-        int next_hour = (current_local.hour + 1) % 24;
-
-        ESP_LOGI(TAG, "Current time: %02d:%02d:%02d, sleeping for %d seconds until %02d:00:30",
-                 current_local.hour, current_local.minute, current_local.second,
-                 sleep_seconds, next_hour);
-    } else {
-        ESP_LOGE(TAG, "Failed to read time for sleep calculation, using default 1 hour");
+    // Network stage (optional): forecast fetch and log upload run in parallel
+    if (network_stage) {
+        wait_stages(STAGE_WIFI_DONE);
     }
 
-    // Flush buffered logs to remote server if WiFi is connected
     if (wifi_connected) {
-        int buffered = remote_logging_get_buffered_count();
-        int dropped = remote_logging_get_dropped_count();
-        if (buffered > 0 || dropped > 0) {
-            ESP_LOGI(TAG, "Flushing %d buffered logs (dropped: %d) to remote server", buffered, dropped);
-            if (remote_logging_flush() == ESP_OK) {
-                ESP_LOGI(TAG, "Remote log flush successful");
-            } else {
-                ESP_LOGW(TAG, "Remote log flush failed, logs will be retried next time");
+        EventBits_t join_bits = STAGE_FLUSH_DONE;
+        if (weather_fetch_due) {
+            start_stage(&FETCH_STAGE, "weather_fetch", STAGE_CORE_NETWORK);
+            join_bits |= STAGE_FETCH_DONE;
+        }
+        start_stage(&FLUSH_STAGE, "log_flush", STAGE_CORE_UPLOAD);
+
+        if (weather_fetch_due) {
+            wait_stages(STAGE_FETCH_DONE);
+
+            // The pin was set above from the previous pin-off hour; the new forecast
+            // can move it past the current hour (or back), so drive the outputs again
+            wake_profiler_begin(WAKE_PHASE_CONTROL_GPIO);
+            control_gpio(&local_time);
+            wake_profiler_end(WAKE_PHASE_CONTROL_GPIO);
+        }
+        wait_stages(join_bits);
+
+        if (flush_result == ESP_OK) {
+            last_log_upload_epoch = now_epoch;
+
+            // Errors logged during the fetch should not wait for the next upload
+            if (remote_logging_has_errors()) {
+                flush_stage();
             }
         }
     }
 
+    // No connection for the fetch: a cached forecast of any age beats the defaults
+    if (weather_fetch_due && !wifi_connected && use_cached_forecast(0)) {
+        weather_fetched = true;
+        wake_profiler_begin(WAKE_PHASE_CONTROL_GPIO);
+        control_gpio(&local_time);
+        wake_profiler_end(WAKE_PHASE_CONTROL_GPIO);
+    }
+
+    // Sleep straight to the next wake that matters (pin on/off, weather check, log upload)
+    int sleep_seconds = calculate_sleep_seconds();
+
     // Shutdown WiFi to save power
-    wifi_shutdown();
+    if (wifi_started) {
+        wake_profiler_begin(WAKE_PHASE_WIFI_SHUTDOWN);
+        wifi_shutdown();
+        wake_profiler_end(WAKE_PHASE_WIFI_SHUTDOWN);
+    }
+
+    // Record total awake time and log where it went
+    wake_profiler_finish_wake();
+    power_profile_finish_wake();
+
+    // Keep unsent logs in RTC memory for the next wake that brings WiFi up
+    remote_logging_retain();
+
+    // Correct the sleep duration for learned timer drift and remember it for the next wake
+    int64_t sleep_us = (int64_t)sleep_seconds * 1000000LL;
+    if (sleep_target_epoch > 0) {
+        sleep_started_utc_us = clock_now_utc_us();
+        sleep_us = sleep_drift_correct(&sleep_drift, (int64_t)sleep_target_epoch * 1000000LL - sleep_started_utc_us);
+        if (sleep_us < 1000000LL) {
+            sleep_us = 1000000LL;
+        }
+        sleep_requested_us = sleep_us;
+    }
+
+#if HW_RTC_ALARM_WAKE_ENABLED
+    // Wake on the DS3231 alarm; the timer only fires if the alarm never arrives
+    if (arm_rtc_alarm_wakeup(sleep_target_epoch)) {
+        ESP_LOGI(TAG, "RTC alarm armed, backup timer %d s later", HW_RTC_ALARM_BACKUP_SECONDS);
+        sleep_us += (int64_t)HW_RTC_ALARM_BACKUP_SECONDS * 1000000LL;
+        sleep_requested_us = 0;  // An alarm wake says nothing about timer drift
+    }
+#endif
 
     // Configure sleep timer and enter deep sleep
-    esp_sleep_enable_timer_wakeup(sleep_seconds * 1000000ULL);
+    esp_sleep_enable_timer_wakeup((uint64_t)sleep_us);
     esp_deep_sleep_start();
 }
@@ -0,0 +1,182 @@
+/**
+ * Host test: DS3231 Alarm 1 register logic against a fake DS3231
+ *
+ * The fake holds the 19 registers of the chip and behaves like it on the bus:
+ * multi-byte accesses auto-increment the register address, status flags can
+ * only be cleared (writing 1 leaves them unchanged), Alarm 1 sets A1F when the
+ * time registers match under the A1Mx/DY-DT mask bits, and INT/SQW is asserted
+ * while INTCN=1 and an enabled alarm flag is set. ds3231_regs.c is run against
+ * it through the same ds3231_bus_t interface rtc_helper.c binds to I2C.
+ */
+
+#include "ds3231_regs.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FAKE_NUM_REGS 0x13
+#define FAKE_BUS_ERROR 0x107  // Any non-zero code; ESP_ERR_TIMEOUT on the device
+
+typedef struct {
+    uint8_t regs[FAKE_NUM_REGS];
+    int reads;
+    int writes;
+    int fail_at;                 // Fail the n-th bus transaction (0 = never)
+    int transactions;
+} fake_ds3231_t;
+
+static int fake_read(void *ctx, uint8_t reg, uint8_t *data, size_t len) {
+    fake_ds3231_t *fake = ctx;
+    if (++fake->transactions == fake->fail_at) {
+        return FAKE_BUS_ERROR;
+    }
+    fake->reads++;
+    for (size_t i = 0; i < len; i++) {
+        data[i] = fake->regs[(reg + i) % FAKE_NUM_REGS];
+    }
+    return 0;
+}
+
+static int fake_write(void *ctx, uint8_t reg, const uint8_t *data, size_t len) {
+    fake_ds3231_t *fake = ctx;
+    if (++fake->transactions == fake->fail_at) {
+        return FAKE_BUS_ERROR;
+    }
+    fake->writes++;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t addr = (uint8_t)((reg + i) % FAKE_NUM_REGS);
+        if (addr == DS3231_REG_STATUS) {
+            // OSF, A2F and A1F can only be cleared; the other bits are writable
+            uint8_t flags = DS3231_STATUS_OSF | DS3231_STATUS_A2F | DS3231_STATUS_A1F;
+            fake->regs[addr] = (uint8_t)((fake->regs[addr] & data[i] & flags) | (data[i] & ~flags));
+        } else {
+            fake->regs[addr] = data[i];
+        }
+    }
+    return 0;
+}
+
+// Set the time registers; Alarm 1 fires when they match (DS3231 datasheet, table 2)
+static void fake_set_time(fake_ds3231_t *fake, int date, int hour, int minute, int second) {
+    fake->regs[0x00] = dec_to_bcd((uint8_t)second);
+    fake->regs[0x01] = dec_to_bcd((uint8_t)minute);
+    fake->regs[0x02] = dec_to_bcd((uint8_t)hour);
+    fake->regs[0x04] = dec_to_bcd((uint8_t)date);
+
+    const uint8_t *alarm = &fake->regs[DS3231_REG_ALARM1];
+    bool match = true;
+    for (int i = 0; i < 3; i++) {
+        if (!(alarm[i] & DS3231_ALARM_MASK) && (alarm[i] & 0x7F) != fake->regs[i]) {
+            match = false;
+        }
+    }
+    if (!(alarm[3] & DS3231_ALARM_MASK)) {
+        uint8_t current = (alarm[3] & DS3231_ALARM_DY_DT) ? fake->regs[0x03] : fake->regs[0x04];
+        if ((alarm[3] & 0x3F) != current) {
+            match = false;
+        }
+    }
+    if (match) {
+        fake->regs[DS3231_REG_STATUS] |= DS3231_STATUS_A1F;
+    }
+}
+
+// INT/SQW is active low while an enabled alarm flag is set in interrupt mode
+static bool fake_int_asserted(const fake_ds3231_t *fake) {
+    uint8_t control = fake->regs[DS3231_REG_CONTROL];
+    uint8_t status = fake->regs[DS3231_REG_STATUS];
+    return (control & DS3231_CONTROL_INTCN) &&
+           (((control & DS3231_CONTROL_A1IE) && (status & DS3231_STATUS_A1F)) ||
+            ((control & DS3231_CONTROL_A2IE) && (status & DS3231_STATUS_A2F)));
+}
+
+// Power-on defaults: EOSC=0, BBSQW=0, CONV=0, RS2=RS1=1, INTCN=1, A2IE=A1IE=0; OSF set
+static void fake_power_on(fake_ds3231_t *fake) {
+    memset(fake, 0, sizeof(*fake));
+    fake->regs[DS3231_REG_CONTROL] = 0x1C;
+    fake->regs[DS3231_REG_STATUS] = DS3231_STATUS_OSF;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+int main(void) {
+    fake_ds3231_t fake;
+    ds3231_bus_t bus = {.read = fake_read, .write = fake_write, .ctx = &fake};
+    uint8_t regs[4];
+    bool was_set;
+
+    printf("Encoding\n");
+    ds3231_encode_alarm1(31, 23, 59, 59, regs);
+    check(regs[0] == 0x59 && regs[1] == 0x59 && regs[2] == 0x23 && regs[3] == 0x31,
+          "31st 23:59:59 -> 59 59 23 31 (BCD, all masks clear)");
+    ds3231_encode_alarm1(1, 0, 0, 0, regs);
+    check(regs[0] == 0 && regs[1] == 0 && regs[2] == 0 && regs[3] == 0x01, "1st 00:00:00 -> 00 00 00 01");
+
+    printf("Set alarm\n");
+    fake_power_on(&fake);
+    fake.regs[DS3231_REG_CONTROL] |= DS3231_CONTROL_BBSQW;
+    fake.regs[DS3231_REG_STATUS] |= DS3231_STATUS_A1F | DS3231_STATUS_A2F;  // Stale flags
+    check(ds3231_set_alarm1(&bus, 17, 15, 0, 0) == 0, "ds3231_set_alarm1() succeeds");
+    check(memcmp(&fake.regs[DS3231_REG_ALARM1], (uint8_t[]){0x00, 0x00, 0x15, 0x17}, 4) == 0,
+          "alarm registers 07-0A = 00 00 15 17");
+    check((fake.regs[DS3231_REG_CONTROL] & (DS3231_CONTROL_INTCN | DS3231_CONTROL_A1IE)) ==
+              (DS3231_CONTROL_INTCN | DS3231_CONTROL_A1IE), "INTCN and A1IE set");
+    check((fake.regs[DS3231_REG_CONTROL] & DS3231_CONTROL_BBSQW) != 0, "other control bits kept (BBSQW)");
+    check(!(fake.regs[DS3231_REG_STATUS] & DS3231_STATUS_A1F), "stale A1F cleared");
+    check((fake.regs[DS3231_REG_STATUS] & (DS3231_STATUS_A2F | DS3231_STATUS_OSF)) ==
+              (DS3231_STATUS_A2F | DS3231_STATUS_OSF), "A2F and OSF left alone");
+    check(!fake_int_asserted(&fake), "INT/SQW released after arming");
+
+    printf("Alarm fires\n");
+    fake_set_time(&fake, 17, 14, 59, 59);
+    check(!fake_int_asserted(&fake), "14:59:59: INT/SQW high");
+    fake_set_time(&fake, 16, 15, 0, 0);
+    check(!fake_int_asserted(&fake), "15:00:00 on the 16th: no match (date)");
+    fake_set_time(&fake, 17, 15, 0, 0);
+    check(fake_int_asserted(&fake), "15:00:00 on the 17th: INT/SQW low");
+    int writes = fake.writes;
+    check(ds3231_clear_alarm1_flag(&bus, &was_set) == 0 && was_set, "clear reports the flag was set");
+    check(!fake_int_asserted(&fake), "INT/SQW released after clearing");
+    check(fake.writes == writes + 1, "one status write to clear");
+    writes = fake.writes;
+    check(ds3231_clear_alarm1_flag(&bus, &was_set) == 0 && !was_set, "second clear: flag was not set");
+    check(fake.writes == writes, "no write when A1F is already clear");
+
+    printf("Re-arm without change\n");
+    writes = fake.writes;
+    check(ds3231_set_alarm1(&bus, 18, 9, 0, 0) == 0, "ds3231_set_alarm1() again");
+    check(fake.writes == writes + 1, "only the alarm registers are written");
+
+    printf("Disable\n");
+    fake_set_time(&fake, 18, 9, 0, 0);
+    check(fake_int_asserted(&fake), "alarm fired before disabling");
+    check(ds3231_disable_alarm1(&bus) == 0, "ds3231_disable_alarm1() succeeds");
+    check(!(fake.regs[DS3231_REG_CONTROL] & DS3231_CONTROL_A1IE), "A1IE cleared");
+    check(!(fake.regs[DS3231_REG_STATUS] & DS3231_STATUS_A1F), "pending A1F cleared");
+    check(!fake_int_asserted(&fake), "INT/SQW released");
+    fake_set_time(&fake, 18, 9, 0, 0);
+    check(!fake_int_asserted(&fake), "matching time no longer asserts INT/SQW");
+
+    printf("Bus errors\n");
+    for (int n = 1; n <= 4; n++) {
+        fake_power_on(&fake);
+        fake.regs[DS3231_REG_STATUS] |= DS3231_STATUS_A1F;
+        fake.fail_at = n;
+        char what[64];
+        snprintf(what, sizeof(what), "set_alarm1 fails on transaction %d -> error returned", n);
+        check(ds3231_set_alarm1(&bus, 1, 0, 0, 0) == FAKE_BUS_ERROR, what);
+    }
+    fake_power_on(&fake);
+    fake.fail_at = 1;
+    check(ds3231_clear_alarm1_flag(&bus, &was_set) == FAKE_BUS_ERROR, "clear_alarm1_flag read error returned");
+    fake_power_on(&fake);
+    fake.fail_at = 1;
+    check(ds3231_disable_alarm1(&bus) == FAKE_BUS_ERROR, "disable_alarm1 read error returned");
+
+    printf("%s\n", failures ? "FAILED" : "All passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * Host benchmark: streaming forecast parsers vs. cJSON DOM
+ *
+ * Parses recorded Open-Meteo responses and reports parse time and peak heap.
+ * The cJSON path is the one fetch_weather_forecast() used before the streaming
+ * parser: cJSON_Parse() of the whole body, then a walk with cJSON_GetArrayItem().
+ * It is run for two-day JSON responses only. Single-day responses (request
+ * limited to tomorrow) need --date; *.csv files use the CSV parser. cJSON is
+ * taken from ESP-IDF, see README.md for the build command.
+ */
+
+#include "forecast_format.h"
+#include "cJSON.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ITERATIONS 2000
+#define CHUNK_SIZE 512  // Typical HTTP_EVENT_ON_DATA chunk
+
+// ============================================================================
+// Heap accounting for cJSON (size header in front of every block)
+// ============================================================================
+
+static size_t s_heap_current;
+static size_t s_heap_peak;
+
+static void *counting_malloc(size_t size) {
+    size_t *block = malloc(sizeof(size_t) + size);
+    if (!block) {
+        return NULL;
+    }
+    block[0] = size;
+    s_heap_current += size;
+    if (s_heap_current > s_heap_peak) {
+        s_heap_peak = s_heap_current;
+    }
+    return block + 1;
+}
+
+static void counting_free(void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    size_t *block = (size_t *)ptr - 1;
+    s_heap_current -= block[0];
+    free(block);
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// Previous path: cJSON DOM walk (same extraction as the old weather_fetch.c)
+// ============================================================================
+
+static bool parse_with_cjson(const char *body, weather_data_t *out) {
+    memset(out, 0, sizeof(*out));
+    cJSON *json = cJSON_Parse(body);
+    if (!json) {
+        return false;
+    }
+
+    int sunrise_hour = -1, sunrise_minute = -1, sunset_hour = -1, sunset_minute = -1;
+    cJSON *daily = cJSON_GetObjectItem(json, "daily");
+    if (daily) {
+        cJSON *daily_time = cJSON_GetObjectItem(daily, "time");
+        cJSON *sunrise_array = cJSON_GetObjectItem(daily, "sunrise");
+        cJSON *sunset_array = cJSON_GetObjectItem(daily, "sunset");
+        if (cJSON_IsArray(daily_time) && cJSON_IsArray(sunrise_array) && cJSON_IsArray(sunset_array) &&
+            cJSON_GetArraySize(daily_time) >= 2) {
+            cJSON *item = cJSON_GetArrayItem(daily_time, 1);
+            if (cJSON_IsString(item)) {
+                strncpy(out->tomorrow_date, cJSON_GetStringValue(item), 10);
+            }
+            item = cJSON_GetArrayItem(sunrise_array, 1);
+            if (cJSON_IsString(item)) {
+                sscanf(cJSON_GetStringValue(item) + 11, "%d:%d", &sunrise_hour, &sunrise_minute);
+            }
+            item = cJSON_GetArrayItem(sunset_array, 1);
+            if (cJSON_IsString(item)) {
+                sscanf(cJSON_GetStringValue(item) + 11, "%d:%d", &sunset_hour, &sunset_minute);
+            }
+        }
+    }
+
+    int start_hour = 6;
+    if (sunrise_hour >= 0 && sunrise_minute >= 0) {
+        start_hour = (sunrise_minute >= 30) ? (sunrise_hour + 2) : (sunrise_hour + 1);
+    }
+    int end_hour = (sunset_hour >= 0) ? (sunset_hour - 1) : 18;
+
+    cJSON *hourly = cJSON_GetObjectItem(json, "hourly");
+    cJSON *time_array = hourly ? cJSON_GetObjectItem(hourly, "time") : NULL;
+    cJSON *cloudcover_array = hourly ? cJSON_GetObjectItem(hourly, "cloudcover") : NULL;
+    if (cJSON_IsArray(time_array) && cJSON_IsArray(cloudcover_array)) {
+        int array_size = cJSON_GetArraySize(time_array);
+        // The old walk counted every date after the first; only the next date is
+        // counted here so responses with more than 2 days compare like for like
+        char first_date[11] = {0};
+        char next_date[11] = {0};
+        float sum = 0.0f;
+        int count = 0;
+        for (int i = 0; i < array_size; i++) {
+            cJSON *time_item = cJSON_GetArrayItem(time_array, i);
+            cJSON *cloudcover_item = cJSON_GetArrayItem(cloudcover_array, i);
+            if (!cJSON_IsString(time_item) || !cJSON_IsNumber(cloudcover_item)) {
+                continue;
+            }
+            const char *timestamp = cJSON_GetStringValue(time_item);
+            if (i == 0) {
+                strncpy(first_date, timestamp, 10);
+            }
+            if (strncmp(timestamp, first_date, 10) != 0 && next_date[0] == '\0') {
+                strncpy(next_date, timestamp, 10);
+            }
+            if (strncmp(timestamp, next_date, 10) == 0) {
+                int hour = 0;
+                sscanf(timestamp + 11, "%d", &hour);
+                if (hour >= start_hour && hour <= end_hour) {
+                    sum += (float)cJSON_GetNumberValue(cloudcover_item);
+                    count++;
+                }
+            }
+        }
+        if (count > 0) {
+            out->tomorrow_cloudcover = sum / count;
+            out->valid = true;
+        }
+    }
+
+    cJSON_Delete(json);
+    return out->valid;
+}
+
+// ============================================================================
+// New path: streaming parser fed in HTTP-sized chunks
+// ============================================================================
+
+static bool parse_streaming(const char *body, size_t len, forecast_format_t format, const char *date,
+                            weather_data_t *out) {
+    forecast_decoder_t decoder;
+    forecast_decoder_init(&decoder, format, date);
+    for (size_t offset = 0; offset < len; offset += CHUNK_SIZE) {
+        size_t chunk = (len - offset < CHUNK_SIZE) ? len - offset : CHUNK_SIZE;
+        forecast_decoder_feed(&decoder, body + offset, chunk);
+    }
+    return forecast_decoder_finish(&decoder, out) == FORECAST_PARSE_OK;
+}
+
+static char *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc(size + 1);
+    if (buf && fread(buf, 1, size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    if (buf) {
+        buf[size] = '\0';
+        *len = (size_t)size;
+    }
+    return buf;
+}
+
+static int bench_file(const char *path, const char *date) {
+    size_t len = 0;
+    char *body = read_file(path, &len);
+    if (!body) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return 1;
+    }
+
+    size_t path_len = strlen(path);
+    forecast_format_t format = (path_len > 4 && strcmp(path + path_len - 4, ".csv") == 0) ?
+                               FORECAST_FORMAT_CSV : FORECAST_FORMAT_JSON;
+    weather_data_t dom_result, stream_result;
+
+    // New path: nothing is allocated, the parser state lives on the stack
+    bool stream_ok = parse_streaming(body, len, format, date, &stream_result);
+    double start = now_us();
+    for (int i = 0; i < ITERATIONS; i++) {
+        parse_streaming(body, len, format, date, &stream_result);
+    }
+    double stream_us = (now_us() - start) / ITERATIONS;
+
+    printf("%s (%zu bytes)\n", path, len);
+    printf("  streaming %-4s: %8.1f us  peak heap %6d bytes  parser state %5zu bytes  -> %s %.1f%%\n",
+           forecast_format_name(format), stream_us, 0, sizeof(forecast_decoder_t),
+           stream_ok ? "ok" : "FAIL", stream_result.tomorrow_cloudcover);
+
+    if (format != FORECAST_FORMAT_JSON || date) {
+        free(body);
+        return stream_ok ? 0 : 1;
+    }
+
+    // Previous path: time and peak heap (the body buffer itself is not counted)
+    s_heap_current = s_heap_peak = 0;
+    bool dom_ok = parse_with_cjson(body, &dom_result);
+    size_t dom_peak = s_heap_peak;
+    start = now_us();
+    for (int i = 0; i < ITERATIONS; i++) {
+        parse_with_cjson(body, &dom_result);
+    }
+    double dom_us = (now_us() - start) / ITERATIONS;
+
+    printf("  cJSON DOM     : %8.1f us  peak heap %6zu bytes  body buffer %6zu bytes  -> %s %.1f%%\n",
+           dom_us, dom_peak, len + 1, dom_ok ? "ok" : "FAIL", dom_result.tomorrow_cloudcover);
+
+    free(body);
+    if (dom_ok != stream_ok || dom_result.tomorrow_cloudcover != stream_result.tomorrow_cloudcover) {
+        printf("  MISMATCH between the two paths\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s [--date YYYY-MM-DD] response.json|response.csv [...]\n", argv[0]);
+        return 2;
+    }
+
+    cJSON_Hooks hooks = {counting_malloc, counting_free};
+    cJSON_InitHooks(&hooks);
+
+    // --date applies to the files after it (responses limited to that day)
+    const char *date = NULL;
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--date") == 0 && i + 1 < argc) {
+            date = argv[++i];
+            continue;
+        }
+        failures += bench_file(argv[i], date);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * Host test: streaming gzip decoder on recorded compressed forecasts
+ *
+ * For every fixture pair (response.json.gz, response.json) the compressed body
+ * is fed to gzip_stream in chunks of several sizes, the inflated output is
+ * compared byte for byte with the plain response, and both are run through the
+ * forecast parser. Truncated and corrupt bodies must be rejected. tinfl comes
+ * from the miniz library on the host (ROM on the device), see README.md.
+ */
+
+#include "gzip_stream.h"
+#include "forecast_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Chunk sizes: single bytes, odd splits, typical TLS record payloads, whole body
+static const size_t CHUNK_SIZES[] = {1, 7, 512, 1460, 0};
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    forecast_parser_t parser;
+} output_t;
+
+static void collect_output(const char *data, size_t len, void *ctx) {
+    output_t *out = ctx;
+    if (out->len + len <= out->cap) {
+        memcpy(out->data + out->len, data, len);
+    }
+    out->len += len;
+    forecast_parser_feed(&out->parser, data, len);
+}
+
+static char *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc(size + 1);
+    if (buf && fread(buf, 1, size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    if (buf) {
+        buf[size] = '\0';
+        *len = (size_t)size;
+    }
+    return buf;
+}
+
+// Decode a compressed body fed in chunk_size pieces (0 = all at once)
+static gzip_stream_result_t decode(const uint8_t *gz, size_t gz_len, size_t chunk_size, output_t *out) {
+    gzip_stream_t *stream = malloc(sizeof(gzip_stream_t));
+    out->len = 0;
+    forecast_parser_init(&out->parser, NULL);
+    gzip_stream_init(stream, collect_output, out);
+
+    size_t step = chunk_size ? chunk_size : gz_len;
+    for (size_t offset = 0; offset < gz_len; offset += step) {
+        size_t chunk = (gz_len - offset < step) ? gz_len - offset : step;
+        gzip_stream_feed(stream, gz + offset, chunk);
+    }
+
+    gzip_stream_result_t result = gzip_stream_finish(stream);
+    free(stream);
+    return result;
+}
+
+static int test_fixture(const char *gz_path) {
+    char plain_path[512];
+    size_t path_len = strlen(gz_path);
+    if (path_len < 4 || path_len >= sizeof(plain_path) || strcmp(gz_path + path_len - 3, ".gz") != 0) {
+        fprintf(stderr, "%s: expected a .gz fixture\n", gz_path);
+        return 1;
+    }
+    memcpy(plain_path, gz_path, path_len - 3);
+    plain_path[path_len - 3] = '\0';
+
+    size_t gz_len = 0, plain_len = 0;
+    char *gz = read_file(gz_path, &gz_len);
+    char *plain = read_file(plain_path, &plain_len);
+    if (!gz || !plain) {
+        fprintf(stderr, "Cannot read %s or %s\n", gz_path, plain_path);
+        free(gz);
+        free(plain);
+        return 1;
+    }
+
+    // Reference result: plain body through the parser
+    forecast_parser_t parser;
+    weather_data_t expected;
+    forecast_parser_init(&parser, NULL);
+    forecast_parser_feed(&parser, plain, plain_len);
+    forecast_parser_finish(&parser, &expected);
+
+    output_t out = {.data = malloc(plain_len), .cap = plain_len};
+    int failures = 0;
+    printf("%s (%zu -> %zu bytes, %.0f%%)\n", gz_path, gz_len, plain_len, 100.0 * gz_len / plain_len);
+
+    for (size_t i = 0; i < sizeof(CHUNK_SIZES) / sizeof(CHUNK_SIZES[0]); i++) {
+        gzip_stream_result_t result = decode((const uint8_t *)gz, gz_len, CHUNK_SIZES[i], &out);
+        weather_data_t actual;
+        forecast_parser_finish(&out.parser, &actual);
+
+        bool ok = result == GZIP_STREAM_OK && out.len == plain_len && memcmp(out.data, plain, plain_len) == 0 &&
+                  actual.valid == expected.valid && actual.tomorrow_cloudcover == expected.tomorrow_cloudcover;
+        printf("  chunk %5zu : %s (%.1f%%)\n", CHUNK_SIZES[i], ok ? "ok" : "FAIL", actual.tomorrow_cloudcover);
+        failures += ok ? 0 : 1;
+    }
+
+    // Truncated body: missing the end of the deflate stream
+    gzip_stream_result_t result = decode((const uint8_t *)gz, gz_len / 2, 512, &out);
+    printf("  truncated  : %s\n", result == GZIP_STREAM_ERR_INCOMPLETE ? "ok" : "FAIL");
+    failures += (result == GZIP_STREAM_ERR_INCOMPLETE) ? 0 : 1;
+
+    // Not gzip: the plain body
+    result = decode((const uint8_t *)plain, plain_len, 512, &out);
+    printf("  not gzip   : %s\n", result == GZIP_STREAM_ERR_FORMAT ? "ok" : "FAIL");
+    failures += (result == GZIP_STREAM_ERR_FORMAT) ? 0 : 1;
+
+    free(out.data);
+    free(gz);
+    free(plain);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s response.json.gz [...]\n", argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        failures += test_fixture(argv[i]);
+    }
+    printf("%s\n", failures ? "FAILED" : "All passed");
+    return failures ? 1 : 0;
+}
@@ -14,14 +14,30 @@ Usage:
 
 Example:
     python log_server.py 3000
+
+Forecast proxy (GET /api/forecast):
+    FORECAST_GRID_DEG=0.1       Grid cell size for sharing upstream responses
+    FORECAST_CYCLE_HOURS=6      Model update cycle (cached responses expire with it)
+    FORECAST_FIXTURE=file[:file] Serve recorded responses instead of Open-Meteo
+
+Decision record (GET /api/decision):
+    HARDWARE_CONFIG_H=path      hardware_config.h with HW_CLOUDCOVER_RANGES
+                                (default: the one in this repository)
 """
 
 import sys
 import os
 import json
-from datetime import datetime, timedelta
+import hashlib
+import re
+import struct
+import threading
+import urllib.error
+import urllib.parse
+import urllib.request
+from datetime import date, datetime, timedelta, timezone
 from pathlib import Path
-from flask import Flask, request, jsonify, render_template_string
+from flask import Flask, Response, request, jsonify, render_template_string
 
 PORT = int(sys.argv[1]) if len(sys.argv) > 1 else 3000
 LOG_DIR = Path(__file__).parent / 'device_logs'
@@ -36,6 +52,21 @@ app = Flask(__name__)
 # Verbose mode (print logs to console)
 VERBOSE = os.environ.get('VERBOSE', '0') == '1'
 
+# Forecast proxy: devices in the same grid cell share one upstream response per model cycle
+OPEN_METEO_URL = 'https://api.open-meteo.com/v1/forecast'
+FORECAST_GRID_DEG = float(os.environ.get('FORECAST_GRID_DEG', '0.1'))
+FORECAST_CYCLE_HOURS = int(os.environ.get('FORECAST_CYCLE_HOURS', '6'))
+FORECAST_FIXTURES = [Path(p) for p in os.environ.get('FORECAST_FIXTURE', '').split(os.pathsep) if p]
+
+forecast_cache = {}
+forecast_lock = threading.Lock()
+
+# Decision endpoint: cloud cover mapping is read from the firmware configuration
+HARDWARE_CONFIG_H = Path(os.environ.get(
+    'HARDWARE_CONFIG_H',
+    Path(__file__).parent.parent.parent / 'components' / 'hardware_config' / 'include' / 'hardware_config.h'))
+DECISION_VERSION = 1
+
 
 @app.route('/health', methods=['GET'])
 def health():
@@ -179,6 +210,31 @@ def receive_diagnostics():
             print(f"  Avg cloudcover: {data['avg_cloudcover']}%")
             print(f"  Pin off hour: {data['pin_off_hour']}, LED count: {data['led_count']}")
             print(f"  Hourly data points: {len(data['hourly'])}")
+            if 'wake_profile' in data:
+                profile = data['wake_profile']
+                print(f"  Wake profile: {profile.get('wakes', 0)} wakes, "
+                      f"avg awake {profile.get('awake', {}).get('avg_ms', 0)} ms")
+            if 'tls' in data:
+                tls = data['tls']
+                print(f"  TLS handshake: {tls.get('handshake_ms', 0)} ms "
+                      f"({'resumed' if tls.get('resumed') else 'full'})")
+            if 'response' in data:
+                response = data['response']
+                print(f"  Forecast response: {response.get('bytes', 0)} bytes"
+                      f"{' (gzip)' if response.get('gzip') else ''}"
+                      f"{' via proxy' if response.get('proxy') else ''}"
+                      f"{' (server decision)' if response.get('decision') else ''}")
+            if 'arena' in data:
+                arena = data['arena']
+                print(f"  Fetch arena: {arena.get('used', 0)} of {arena.get('size', 0)} bytes "
+                      f"(peak {arena.get('peak', 0)})")
+            if data.get('cache', {}).get('used'):
+                print(f"  Forecast from RTC cache ({data['cache'].get('age_h', 0)} h old)")
+            if 'power_profile' in data:
+                power = data['power_profile']
+                print(f"  Power profile (avg per wake): max freq {power.get('max_freq_ms', 0)} ms, "
+                      f"low freq {power.get('low_freq_ms', 0)} ms, "
+                      f"light sleep {power.get('light_sleep_ms', 0)} ms")
 
         return jsonify({
             'success': True,
@@ -256,6 +312,242 @@ def get_diagnostic_file(filename):
         return jsonify({'error': 'Internal server error'}), 500
 
 
+def forecast_cycle_start(now):
+    """Start of the model update cycle `now` falls in (UTC)"""
+    hour = now.hour - now.hour % FORECAST_CYCLE_HOURS
+    return now.replace(hour=hour, minute=0, second=0, microsecond=0)
+
+
+def snap_to_grid(value):
+    """Center of the grid cell a coordinate falls in"""
+    return round(round(float(value) / FORECAST_GRID_DEG) * FORECAST_GRID_DEG, 4)
+
+
+def load_fixture(params):
+    """Recorded response for the requested format, dates moved to start at start_date (or today)"""
+    want_csv = params.get('format') == 'csv'
+    for path in FORECAST_FIXTURES:
+        if (path.suffix == '.csv') == want_csv:
+            body = path.read_text(encoding='utf-8')
+            break
+    else:
+        raise FileNotFoundError(f"no {'CSV' if want_csv else 'JSON'} fixture in FORECAST_FIXTURE")
+
+    # Shift every date so the first one matches the request (the device looks for tomorrow)
+    first = re.search(r'\d{4}-\d{2}-\d{2}', body)
+    if first:
+        start = date.fromisoformat(params['start_date']) if 'start_date' in params else date.today()
+        delta = start - date.fromisoformat(first.group(0))
+        body = re.sub(r'\d{4}-\d{2}-\d{2}',
+                      lambda m: (date.fromisoformat(m.group(0)) + delta).isoformat(), body)
+    content_type = 'text/csv' if want_csv else 'application/json'
+    return body.encode('utf-8'), content_type
+
+
+def fetch_upstream(params):
+    """Forecast response from Open-Meteo (or the fixture)"""
+    if FORECAST_FIXTURES:
+        return load_fixture(params)
+
+    url = f"{OPEN_METEO_URL}?{urllib.parse.urlencode(params)}"
+    with urllib.request.urlopen(url, timeout=15) as response:
+        return response.read(), response.headers.get('Content-Type', 'application/json')
+
+
+def cached_forecast(params):
+    """Forecast for the grid cell of params, fetched upstream once per model cycle
+
+    Returns (params with snapped coordinates, cache entry, source, cycle start).
+    Entries are also keyed by date: a forecast_days request starts at today,
+    so its response changes at midnight even within a cycle.
+    """
+    # Everything in the same grid cell gets the forecast of the cell center
+    params = dict(params)
+    params['latitude'] = f"{snap_to_grid(params['latitude']):.4f}"
+    params['longitude'] = f"{snap_to_grid(params['longitude']):.4f}"
+    cycle = forecast_cycle_start(datetime.now(timezone.utc))
+    today = date.today()
+    key = (cycle, today, tuple(sorted(params.items())))
+
+    # One upstream request per key, even when the whole fleet asks at once
+    with forecast_lock:
+        for old_key in [k for k in forecast_cache if k[:2] != (cycle, today)]:
+            del forecast_cache[old_key]
+
+        entry = forecast_cache.get(key)
+        if entry is None:
+            body, content_type = fetch_upstream(params)
+            entry = {
+                'body': body,
+                'content_type': content_type,
+                'etag': '"' + hashlib.sha1(body).hexdigest()[:16] + '"',
+                'hits': 0,
+            }
+            forecast_cache[key] = entry
+            source = 'fixture' if FORECAST_FIXTURES else 'upstream'
+        else:
+            source = 'cache'
+        entry['hits'] += 1
+    return params, entry, source, cycle
+
+
+@app.route('/api/forecast', methods=['GET'])
+def forecast_proxy():
+    """Open-Meteo forecast proxy (same query parameters as /v1/forecast)"""
+    try:
+        params = request.args.to_dict()
+        if 'latitude' not in params or 'longitude' not in params:
+            return jsonify({'error': 'latitude and longitude are required'}), 400
+
+        params, entry, source, cycle = cached_forecast(params)
+
+        not_modified = request.headers.get('If-None-Match') == entry['etag']
+        print(f"[{datetime.now().isoformat()}] Forecast {params['latitude']},{params['longitude']} "
+              f"cycle {cycle:%H}Z from {source} ({len(entry['body'])} bytes, "
+              f"{'304' if not_modified else '200'}, {entry['hits']} requests)")
+
+        headers = {'ETag': entry['etag'], 'X-Forecast-Cache': 'hit' if source == 'cache' else 'miss'}
+        if not_modified:
+            return Response(status=304, headers=headers)
+        return Response(entry['body'], mimetype=entry['content_type'], headers=headers)
+
+    except (urllib.error.URLError, OSError, ValueError) as e:
+        print(f"Error fetching forecast: {e}")
+        return jsonify({'error': 'Upstream forecast unavailable'}), 502
+    except Exception as e:
+        print(f"Error serving forecast: {e}")
+        return jsonify({'error': 'Internal server error'}), 500
+
+
+def load_device_config():
+    """HW_CLOUDCOVER_RANGES and HW_NUM_LEDS from the firmware's hardware_config.h
+
+    Reading the header keeps the server's decision identical to what the
+    firmware would compute without rebuilding anything on either side.
+    """
+    text = HARDWARE_CONFIG_H.read_text(encoding='utf-8')
+    block = re.search(r'HW_CLOUDCOVER_RANGES\[[^\]]*\]\s*=\s*\{(.*?)\};', text, re.S)
+    num_leds = re.search(r'#define\s+HW_NUM_LEDS\s+(\d+)', text)
+    if not block or not num_leds:
+        raise ValueError(f"HW_CLOUDCOVER_RANGES / HW_NUM_LEDS not found in {HARDWARE_CONFIG_H}")
+
+    # Entries look like {0.0f,  10.0f, 22}; comments are stripped first
+    entries = re.sub(r'//[^\n]*', '', block.group(1))
+    ranges = [(float(lo), float(hi), int(hour)) for lo, hi, hour in
+              re.findall(r'\{\s*([\d.]+)f?\s*,\s*([\d.]+)f?\s*,\s*(\d+)\s*\}', entries)]
+    if not ranges:
+        raise ValueError(f"HW_CLOUDCOVER_RANGES is empty in {HARDWARE_CONFIG_H}")
+    return ranges, int(num_leds.group(1))
+
+
+def decide(cloudcover, ranges, num_leds):
+    """pin_off_hour and LED count for an average cloud cover (main.c / cloudcover_leds.c)"""
+    index = None
+    for i, (lo, hi, _) in enumerate(ranges):
+        if lo <= cloudcover < hi:
+            index = i
+            break
+    if index is None and cloudcover >= ranges[-1][1]:
+        index = len(ranges) - 1
+
+    pin_off_hour = ranges[index][2] if index is not None else 17
+
+    # LED count: clamp to 0-100, proportional to the inverted range index
+    clamped = min(max(cloudcover, 0.0), 100.0)
+    led_index = next((i for i, (lo, hi, _) in enumerate(ranges) if lo <= clamped < hi),
+                     len(ranges) - 1 if clamped >= ranges[-1][1] else None)
+    if led_index is None:
+        led_count = 0
+    elif len(ranges) == 1:
+        led_count = num_leds
+    else:
+        led_count = (len(ranges) - 1 - led_index) * num_leds // (len(ranges) - 1)
+    return pin_off_hour, led_count
+
+
+def daytime_average(forecast, day):
+    """Hourly cloud cover of a day and its daytime average (forecast_values.c window)"""
+    hourly = [None] * 24
+    times = forecast['hourly']['time']
+    for timestamp, value in zip(times, forecast['hourly']['cloudcover']):
+        if timestamp.startswith(day) and value is not None:
+            hourly[int(timestamp[11:13])] = int(min(max(value, 0), 100) + 0.5)
+
+    start_hour, end_hour = 6, 18
+    daily = forecast.get('daily', {})
+    if day in daily.get('time', []):
+        i = daily['time'].index(day)
+        sunrise, sunset = daily['sunrise'][i], daily['sunset'][i]
+        sunrise_hour, sunrise_minute = int(sunrise[11:13]), int(sunrise[14:16])
+        start_hour = sunrise_hour + (2 if sunrise_minute >= 30 else 1)
+        end_hour = int(sunset[11:13]) - 1
+
+    window = [hourly[h] for h in range(max(start_hour, 0), min(end_hour, 23) + 1) if hourly[h] is not None]
+    return hourly, (sum(window) / len(window) if window else None)
+
+
+def crc16_ccitt(data):
+    """CRC-16/CCITT-FALSE (forecast_decision.c)"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def pack_decision(day, pin_off_hour, led_count, average, hourly):
+    """32-byte decision record (layout in components/weather_client/include/forecast_decision.h)"""
+    days = (date.fromisoformat(day) - date(2000, 1, 1)).days
+    record = struct.pack('<BBHBB24s', DECISION_VERSION, pin_off_hour, days, led_count,
+                         min(int(average * 2 + 0.5), 200),
+                         bytes(0xFF if v is None else v for v in hourly))
+    return record + struct.pack('<H', crc16_ccitt(record))
+
+
+@app.route('/api/decision', methods=['GET'])
+def forecast_decision():
+    """Tomorrow's pin-off hour and LED count as a 32-byte binary record"""
+    try:
+        params = request.args.to_dict()
+        if 'latitude' not in params or 'longitude' not in params or 'date' not in params:
+            return jsonify({'error': 'latitude, longitude and date are required'}), 400
+        day = date.fromisoformat(params['date']).isoformat()
+
+        # Same cache as /api/forecast: one upstream request per cell, cycle and date
+        upstream = {
+            'latitude': params['latitude'],
+            'longitude': params['longitude'],
+            'daily': 'sunrise,sunset',
+            'hourly': 'cloudcover',
+            'timezone': 'auto',
+            'start_date': day,
+            'end_date': day,
+        }
+        upstream, entry, source, cycle = cached_forecast(upstream)
+
+        hourly, average = daytime_average(json.loads(entry['body']), day)
+        if average is None:
+            print(f"[{datetime.now().isoformat()}] Decision {day}: no daytime cloud cover in the forecast")
+            return jsonify({'error': f'No daytime cloud cover for {day}'}), 502
+
+        ranges, num_leds = load_device_config()
+        pin_off_hour, led_count = decide(average, ranges, num_leds)
+        print(f"[{datetime.now().isoformat()}] Decision {day} for {upstream['latitude']},{upstream['longitude']}: "
+              f"{average:.1f}% -> pin off at {pin_off_hour}:00, {led_count} LEDs (forecast from {source})")
+
+        return Response(pack_decision(day, pin_off_hour, led_count, average, hourly),
+                        mimetype='application/octet-stream')
+
+    except (urllib.error.URLError, OSError, ValueError, KeyError) as e:
+        print(f"Error computing decision: {e}")
+        return jsonify({'error': 'Forecast unavailable'}), 502
+    except Exception as e:
+        print(f"Error serving decision: {e}")
+        return jsonify({'error': 'Internal server error'}), 500
+
+
 def get_cloudcover_color(cloudcover):
     """Get CSS color class based on cloudcover percentage"""
     if cloudcover < 10:
@@ -553,6 +845,66 @@ def diagnostics_page():
                     </tbody>
                 </table>
             </div>
+
+            {% if diagnostic_data.wake_profile %}
+            <!-- Wake Profile Table -->
+            <div class="section">
+                <div class="section-title">Wake Profile ({{ diagnostic_data.wake_profile.wakes }} wakes, avg awake {{ "%.1f"|format(diagnostic_data.wake_profile.awake.avg_ms) }} ms)</div>
+                <table>
+                    <thead>
+                        <tr>
+                            <th>Phase</th>
+                            <th>Samples</th>
+                            <th>Min (ms)</th>
+                            <th>Avg (ms)</th>
+                            <th>Max (ms)</th>
+                            <th>Stack free (B)</th>
+                        </tr>
+                    </thead>
+                    <tbody>
+                        {% for name, stats in diagnostic_data.wake_profile.phases.items() %}
+                        <tr>
+                            <td style="font-weight: 600;">{{ name }}</td>
+                            <td>{{ stats.n }}</td>
+                            <td>{{ "%.1f"|format(stats.min_ms) }}</td>
+                            <td>{{ "%.1f"|format(stats.avg_ms) }}</td>
+                            <td>{{ "%.1f"|format(stats.max_ms) }}</td>
+                            <td>{% if stats.stack %}{{ stats.stack_free }} of {{ stats.stack }}{% endif %}</td>
+                        </tr>
+                        {% endfor %}
+                    </tbody>
+                </table>
+            </div>
+            {% endif %}
+
+            {% if diagnostic_data.power_profile %}
+            <!-- Power Profile Table -->
+            <div class="section">
+                <div class="section-title">Power Profile (average per wake over {{ diagnostic_data.power_profile.wakes }} wakes)</div>
+                <table>
+                    <thead>
+                        <tr>
+                            <th>State</th>
+                            <th>Time (ms)</th>
+                        </tr>
+                    </thead>
+                    <tbody>
+                        <tr>
+                            <td style="font-weight: 600;">Max CPU frequency</td>
+                            <td>{{ diagnostic_data.power_profile.max_freq_ms }}</td>
+                        </tr>
+                        <tr>
+                            <td style="font-weight: 600;">Low CPU frequency</td>
+                            <td>{{ diagnostic_data.power_profile.low_freq_ms }}</td>
+                        </tr>
+                        <tr>
+                            <td style="font-weight: 600;">Light sleep</td>
+                            <td>{{ diagnostic_data.power_profile.light_sleep_ms }}</td>
+                        </tr>
+                    </tbody>
+                </table>
+            </div>
+            {% endif %}
             {% else %}
             <div class="no-data">
                 <p>📭 No diagnostic data available yet.</p>
@@ -591,6 +943,10 @@ if __name__ == '__main__':
     print(f'  POST http://localhost:{PORT}/api/diagnostics  - Receive diagnostics from ESP32')
     print(f'  GET  http://localhost:{PORT}/api/diagnostics  - List diagnostics (30-day retention)')
     print(f'  GET  http://localhost:{PORT}/diagnostics      - View diagnostics web page')
+    print(f'  GET  http://localhost:{PORT}/api/forecast     - Forecast proxy for ESP32 '
+          f'({"fixture" if FORECAST_FIXTURES else "Open-Meteo"}, {FORECAST_GRID_DEG} deg cells, '
+          f'{FORECAST_CYCLE_HOURS} h cycles)')
+    print(f'  GET  http://localhost:{PORT}/api/decision     - Decision record for ESP32 (32 bytes)')
     print(f'  GET  http://localhost:{PORT}/health           - Health check')
     print()
     print('Set VERBOSE=1 to print all log messages to console')
@@ -0,0 +1,206 @@
+/**
+ * Host check: on-device sunrise/sunset against a double precision reference
+ *
+ * The firmware computes sunrise and sunset in single precision with one
+ * refinement step (solar_position.c). The reference here evaluates the same
+ * NOAA equations in double precision and iterates the event time until it
+ * converges. Every day of several years is compared on a latitude/longitude
+ * grid up to 65 degrees; any difference of a minute or more fails. The
+ * reference equations are checked against the worked examples in Meeus, and
+ * the firmware itself against published sunrise and sunset times.
+ */
+
+#include "solar_position.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PI 3.14159265358979323846
+#define RAD(x) ((x) * PI / 180.0)
+#define DEG(x) ((x) * 180.0 / PI)
+
+// ============================================================================
+// Reference: NOAA equations in double precision, iterated to convergence
+// ============================================================================
+
+// Julian day of 00:00 UTC of a civil date (Meeus, chapter 7)
+static double julian_day(int year, int month, int day) {
+    if (month <= 2) {
+        year -= 1;
+        month += 12;
+    }
+    int a = year / 100;
+    int b = 2 - a + a / 4;
+    return floor(365.25 * (year + 4716)) + floor(30.6001 * (month + 1)) + day + b - 1524.5;
+}
+
+static void reference_sun(double jd, double *declination, double *equation_of_time) {
+    double t = (jd - 2451545.0) / 36525.0;
+    double l0 = fmod(280.46646 + t * (36000.76983 + t * 0.0003032), 360.0);
+    double m = 357.52911 + t * (35999.05029 - 0.0001537 * t);
+    double e = 0.016708634 - t * (0.000042037 + 0.0000001267 * t);
+    double c = sin(RAD(m)) * (1.914602 - t * (0.004817 + 0.000014 * t)) +
+               sin(RAD(2 * m)) * (0.019993 - 0.000101 * t) + sin(RAD(3 * m)) * 0.000289;
+    double omega = 125.04 - 1934.136 * t;
+    double lambda = l0 + c - 0.00569 - 0.00478 * sin(RAD(omega));
+    double eps0 = 23.0 + (26.0 + (21.448 - t * (46.815 + t * (0.00059 - t * 0.001813))) / 60.0) / 60.0;
+    double eps = eps0 + 0.00256 * cos(RAD(omega));
+    *declination = asin(sin(RAD(eps)) * sin(RAD(lambda)));
+
+    double y = tan(RAD(eps) / 2.0);
+    y *= y;
+    double eot = y * sin(2 * RAD(l0)) - 2 * e * sin(RAD(m)) + 4 * e * y * sin(RAD(m)) * cos(2 * RAD(l0)) -
+                 0.5 * y * y * sin(4 * RAD(l0)) - 1.25 * e * e * sin(2 * RAD(m));
+    *equation_of_time = 4.0 * DEG(eot);
+}
+
+// Minutes after 00:00 UTC; false for polar day/night
+static bool reference_event(int year, int month, int day, double lat, double lon, bool rising, double *minutes) {
+    double jd0 = julian_day(year, month, day);
+    double estimate = 720.0 - 4.0 * lon;
+    for (int i = 0; i < 20; i++) {
+        double declination, eot;
+        reference_sun(jd0 + estimate / 1440.0, &declination, &eot);
+        double cos_ha = cos(RAD(90.833)) / (cos(RAD(lat)) * cos(declination)) - tan(RAD(lat)) * tan(declination);
+        if (cos_ha > 1.0 || cos_ha < -1.0) {
+            return false;
+        }
+        double ha = DEG(acos(cos_ha));
+        double next = 720.0 - 4.0 * lon - eot + (rising ? -4.0 : 4.0) * ha;
+        bool converged = fabs(next - estimate) < 0.001;
+        estimate = next;
+        if (converged) {
+            break;
+        }
+    }
+    *minutes = estimate;
+    return true;
+}
+
+// ============================================================================
+// Worked examples from Meeus, Astronomical Algorithms (2nd ed.)
+// ============================================================================
+
+typedef struct {
+    const char *example;
+    int year, month, day;           // 0h of the date
+    double declination_deg;         // Apparent declination
+    double equation_of_time_min;
+} meeus_example_t;
+
+static const meeus_example_t MEEUS[] = {
+    // Example 25.a (declination -7 47' 06") and example 28.b (E = 13m 42.6s), 1992 October 13
+    {"25.a/28.b", 1992, 10, 13, -7.78507, 13.710},
+};
+
+// ============================================================================
+// Published sunrise/sunset times (minute resolution)
+// ============================================================================
+
+typedef struct {
+    const char *place;
+    double latitude, longitude;
+    int year, month, day;
+    int sunrise_utc_min;            // Minutes after 00:00 UTC (-1 = not published)
+    int sunset_utc_min;
+    const char *source;
+} published_times_t;
+
+static const published_times_t PUBLISHED[] = {
+    // Almanac for Computers 1990 worked example: sunrise 5:26 a.m. EDT
+    {"Wayne, NJ", 40.9, -74.3, 1990, 6, 25, 9 * 60 + 26, -1, "USNO Almanac for Computers"},
+    // Equinox: 06:02 / 18:14 GMT
+    {"London", 51.5074, -0.1278, 2024, 3, 20, 6 * 60 + 2, 18 * 60 + 14, "timeanddate.com"},
+    // Solstice: 04:43 / 21:21 BST
+    {"London", 51.5074, -0.1278, 2024, 6, 20, 3 * 60 + 43, 20 * 60 + 21, "timeanddate.com"},
+    // Solstice: 5:25 a.m. / 8:31 p.m. EDT
+    {"New York", 40.7128, -74.0060, 2024, 6, 20, 9 * 60 + 25, 24 * 60 + 31, "timeanddate.com"},
+};
+
+static int days_in_month(int year, int month) {
+    static const int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return (month == 2 && leap) ? 29 : DAYS[month - 1];
+}
+
+int main(void) {
+    static const int YEARS[] = {2024, 2025, 2026, 2030, 2040};
+    int failures = 0;
+    long compared = 0;
+    double max_error = 0.0;
+    double sum_error = 0.0;
+
+    for (size_t y = 0; y < sizeof(YEARS) / sizeof(YEARS[0]); y++) {
+        for (int month = 1; month <= 12; month++) {
+            for (int day = 1; day <= days_in_month(YEARS[y], month); day++) {
+                for (int lat = -65; lat <= 65; lat += 5) {
+                    for (int lon = -180; lon <= 180; lon += 15) {
+                        int sunrise, sunset;
+                        double ref_sunrise, ref_sunset;
+                        bool ref_ok = reference_event(YEARS[y], month, day, lat, lon, true, &ref_sunrise) &&
+                                      reference_event(YEARS[y], month, day, lat, lon, false, &ref_sunset);
+                        solar_result_t result = solar_sun_times(YEARS[y], month, day, (float)lat, (float)lon,
+                                                                &sunrise, &sunset);
+                        if (!ref_ok || result != SOLAR_OK) {
+                            if (ref_ok != (result == SOLAR_OK)) {
+                                printf("%04d-%02d-%02d %+d %+d: polar mismatch\n", YEARS[y], month, day, lat, lon);
+                                failures++;
+                            }
+                            continue;
+                        }
+
+                        double errors[2] = {fabs(sunrise - ref_sunrise), fabs(sunset - ref_sunset)};
+                        for (int i = 0; i < 2; i++) {
+                            compared++;
+                            sum_error += errors[i];
+                            if (errors[i] > max_error) {
+                                max_error = errors[i];
+                            }
+                            if (errors[i] >= 1.0) {
+                                printf("%04d-%02d-%02d %+d %+d: %s off by %.2f min\n", YEARS[y], month, day,
+                                       lat, lon, i == 0 ? "sunrise" : "sunset", errors[i]);
+                                failures++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    printf("Reference grid: %ld times, mean error %.2f min, max %.2f min (incl. rounding)\n",
+           compared, sum_error / compared, max_error);
+
+    // The reference equations themselves against the book (the grid only compares float and double)
+    for (size_t i = 0; i < sizeof(MEEUS) / sizeof(MEEUS[0]); i++) {
+        const meeus_example_t *ex = &MEEUS[i];
+        double declination, eot;
+        reference_sun(julian_day(ex->year, ex->month, ex->day), &declination, &eot);
+        double declination_error = fabs(DEG(declination) - ex->declination_deg);
+        double eot_error = fabs(eot - ex->equation_of_time_min);
+        bool ok = declination_error < 0.01 && eot_error < 0.1;
+        printf("Meeus %s: declination %.5f (%.5f), equation of time %.3f min (%.3f) %s\n", ex->example,
+               DEG(declination), ex->declination_deg, eot, ex->equation_of_time_min, ok ? "ok" : "FAIL");
+        failures += ok ? 0 : 1;
+    }
+
+    // The firmware against published times; both are rounded to the minute
+    for (size_t i = 0; i < sizeof(PUBLISHED) / sizeof(PUBLISHED[0]); i++) {
+        const published_times_t *pub = &PUBLISHED[i];
+        int sunrise, sunset;
+        bool ok = solar_sun_times(pub->year, pub->month, pub->day, (float)pub->latitude, (float)pub->longitude,
+                                  &sunrise, &sunset) == SOLAR_OK;
+        ok = ok && (pub->sunrise_utc_min < 0 || abs(sunrise - pub->sunrise_utc_min) < 1) &&
+             (pub->sunset_utc_min < 0 || abs(sunset - pub->sunset_utc_min) < 1);
+        printf("%-9s %04d-%02d-%02d: sunrise %02d:%02d UTC", pub->place, pub->year, pub->month, pub->day,
+               sunrise / 60, sunrise % 60);
+        if (pub->sunset_utc_min >= 0) {
+            printf(", sunset %02d:%02d UTC", sunset / 60 % 24, sunset % 60);
+        }
+        printf(" (%s) %s\n", pub->source, ok ? "ok" : "FAIL");
+        failures += ok ? 0 : 1;
+    }
+
+    printf("%s\n", failures ? "FAILED" : "All passed");
+    return failures ? 1 : 0;
+}
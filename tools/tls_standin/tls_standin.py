@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""
+Local TLS stand-in for api.open-meteo.com
+
+HTTPS server that answers /v1/forecast with a recorded Open-Meteo response and
+reports, for every connection, whether the TLS session was resumed and how long
+the handshake took. Used to check session resumption on the host (see README.md).
+
+TLS 1.2 with session tickets and session IDs, like the firmware negotiates. A
+self-signed certificate is generated with the openssl CLI on first start.
+
+Usage:
+    python tls_standin.py [port] [fixture.json]
+    Default port: 8443, default fixture: ../forecast_bench/fixtures/open_meteo_2day.json
+"""
+
+import socket
+import ssl
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+HERE = Path(__file__).parent
+PORT = int(sys.argv[1]) if len(sys.argv) > 1 else 8443
+FIXTURE = Path(sys.argv[2]) if len(sys.argv) > 2 else \
+    HERE.parent / 'forecast_bench' / 'fixtures' / 'open_meteo_2day.json'
+CERT = HERE / 'standin_cert.pem'
+KEY = HERE / 'standin_key.pem'
+
+
+def ensure_certificate():
+    if CERT.exists() and KEY.exists():
+        return
+    subprocess.run(['openssl', 'req', '-x509', '-newkey', 'ec', '-pkeyopt', 'ec_paramgen_curve:prime256v1',
+                    '-nodes', '-days', '365', '-subj', '/CN=localhost',
+                    '-keyout', str(KEY), '-out', str(CERT)],
+                   check=True, capture_output=True)
+    print(f"Generated self-signed certificate {CERT.name}")
+
+
+def make_context():
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.minimum_version = ssl.TLSVersion.TLSv1_2
+    context.maximum_version = ssl.TLSVersion.TLSv1_2
+    context.load_cert_chain(CERT, KEY)
+    context.num_tickets = 1
+    return context
+
+
+def read_request(conn):
+    data = b''
+    while b'\r\n\r\n' not in data and len(data) < 4096:
+        chunk = conn.recv(1024)
+        if not chunk:
+            break
+        data += chunk
+    return data.split(b'\r\n', 1)[0].decode(errors='replace')
+
+
+def respond(conn, request_line, body):
+    parts = request_line.split()
+    if len(parts) >= 2 and parts[0] == 'GET' and parts[1].startswith('/v1/forecast'):
+        status, payload = '200 OK', body
+    else:
+        status, payload = '404 Not Found', b'{"error":true}'
+    # HTTP/1.0 semantics: the body ends when the connection is closed
+    conn.sendall(f"HTTP/1.0 {status}\r\nContent-Type: application/json\r\n"
+                 f"Content-Length: {len(payload)}\r\nConnection: close\r\n\r\n".encode() + payload)
+    return status
+
+
+def main():
+    ensure_certificate()
+    body = FIXTURE.read_bytes()
+    context = make_context()
+
+    with socket.create_server(('0.0.0.0', PORT)) as server:
+        print(f"TLS stand-in on port {PORT}, serving {FIXTURE.name} ({len(body)} bytes)")
+        while True:
+            raw, address = server.accept()
+            start = time.perf_counter()
+            try:
+                conn = context.wrap_socket(raw, server_side=True)
+            except (ssl.SSLError, OSError) as e:
+                print(f"{address[0]}: handshake failed: {e}")
+                raw.close()
+                continue
+            handshake_ms = (time.perf_counter() - start) * 1000
+            try:
+                request_line = read_request(conn)
+                status = respond(conn, request_line, body)
+                print(f"{address[0]}: {conn.version()} {'resumed' if conn.session_reused else 'full'} "
+                      f"handshake {handshake_ms:.1f} ms, {request_line!r} -> {status}")
+            except (ssl.SSLError, OSError) as e:
+                print(f"{address[0]}: {e}")
+            finally:
+                conn.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,316 @@
+/**
+ * Host check: event-driven wake schedule on a simulated clock
+ *
+ * Steps a simulated clock through several days (including both DST changes of
+ * HW_TIMEZONE_POSIX) with two models of the device side by side:
+ *
+ * - the reference wakes every hour, like the firmware before the event-driven
+ *   scheduler: fetch at HW_WEATHER_CHECK_HOUR, then drive the pin;
+ * - the scheduled device only wakes at the hours wake_scheduler_next() picks,
+ *   with the sleep target computed like calculate_sleep_seconds() in main.c,
+ *   and runs a wake in the order of app_main(): the local stage drives the pin
+ *   from the stored pin-off hour, then the fetch applies the new forecast and
+ *   the outputs are driven again.
+ *
+ * After every hour the pin, the LED display (weather fetched and pin on) and the
+ * pin-off hour of both must match, every day must have its weather check wake,
+ * and log uploads must not be more than one hour past HW_LOG_UPLOAD_INTERVAL_HOURS
+ * apart.
+ *
+ * The 16:00 scenario moves the pin-off hour across the weather check hour in
+ * both directions (17 -> 13 turns the pin off, 15 -> 20 turns it back on). It
+ * also runs once without driving the outputs again after the fetch, which must
+ * be caught.
+ *
+ * No scheduled wake may be a no-op (no output change, no fetch, no WiFi). The
+ * WiFi-down scenario has too many failed connects in a row, so WiFi is only
+ * tried for the weather check and the forecast comes from the cache. It also
+ * runs once with log upload wakes still scheduled, whose no-op wakes must be
+ * caught.
+ */
+
+#include "wake_scheduler.h"
+#include "network_policy.h"
+#include "hardware_config.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if HW_RTC_ALARM_WAKE_ENABLED
+    #define WAKE_TARGET_SECOND 0
+#else
+    #define WAKE_TARGET_SECOND HW_WAKE_TARGET_SECOND
+#endif
+
+// Default pin-off hour after a cold boot (main.c)
+#define DEFAULT_PIN_OFF_HOUR 17
+
+typedef struct {
+    const char *name;
+    int year, month, day;        // First day, simulation starts at 12:00 local
+    int days;
+    const int *pin_off_hours;    // Forecast result of each day's fetch (for the next day)
+} scenario_t;
+
+// Device state kept in RTC memory across deep sleep
+typedef struct {
+    int pin_off_hour;
+    bool weather_fetched;
+    bool pin;
+    time_t last_upload;          // 0 = never
+    int fetches;
+    int noop_wakes;              // Wakes that changed nothing and kept WiFi off
+    bool reevaluate_after_fetch; // Drive the outputs again after the forecast (app_main)
+    bool wifi_down;              // Too many failed connects: WiFi only for the weather check
+    bool uploads_blocked;        // Scheduler told to drop log upload wakes (main.c)
+    uint32_t planned_events;     // WAKE_EVENT_* bits of the next wake (planned_wake_events)
+} device_t;
+
+static bool leds_on(const device_t *dev) {
+    return dev->weather_fetched && dev->pin;
+}
+
+static int local_hour(time_t t) {
+    struct tm tm;
+    localtime_r(&t, &tm);
+    return tm.tm_hour;
+}
+
+static int day_index(time_t start, time_t t) {
+    struct tm a, b;
+    localtime_r(&start, &a);
+    localtime_r(&t, &b);
+    a.tm_hour = b.tm_hour = 12;
+    a.tm_min = b.tm_min = a.tm_sec = b.tm_sec = 0;
+    a.tm_isdst = b.tm_isdst = -1;
+    return (int)((mktime(&b) - mktime(&a) + 43200) / 86400);
+}
+
+// control_gpio(): pin from the schedule, a falling edge clears weather_fetched
+static void drive_outputs(device_t *dev, int hour) {
+    wake_schedule_t schedule = {.pin_on_hour = HW_PIN_ON_HOUR, .pin_off_hour = dev->pin_off_hour};
+    bool activate = wake_scheduler_pin_active(&schedule, hour);
+    if (dev->pin && !activate) {
+        dev->weather_fetched = false;
+    }
+    dev->pin = activate;
+}
+
+// One wake; returns true if WiFi came up (logs were uploaded)
+static bool wake(device_t *dev, const scenario_t *sc, time_t start, time_t now, bool local_stage_first) {
+    int hour = local_hour(now);
+    bool fetch_due = (hour == HW_WEATHER_CHECK_HOUR && !dev->weather_fetched);
+
+    network_policy_input_t input = {
+        .weather_fetch_due = fetch_due,
+        .seconds_since_upload = dev->last_upload ? (long)(now - dev->last_upload) : -1,
+        .max_staleness_seconds = (long)HW_LOG_UPLOAD_INTERVAL_HOURS * 3600,
+        .upload_wake = (dev->planned_events & WAKE_EVENT_LOG_UPLOAD) != 0,
+    };
+    bool network = network_policy_evaluate(&input) != NETWORK_REASON_NONE;
+    bool pin_before = dev->pin, leds_before = leds_on(dev);
+
+    // wifi_reconnect_wake_allowed(): only the fetch brings WiFi up, and it fails
+    if (dev->wifi_down) {
+        network = false;
+    }
+
+    // app_main() drives the outputs from the stored pin-off hour before the fetch
+    if (local_stage_first) {
+        drive_outputs(dev, hour);
+    }
+
+    if (fetch_due) {
+        int day = day_index(start, now);
+        dev->pin_off_hour = sc->pin_off_hours[day % sc->days];
+        dev->weather_fetched = true;
+        dev->fetches++;
+    }
+    if (!local_stage_first || (fetch_due && dev->reevaluate_after_fetch)) {
+        drive_outputs(dev, hour);
+    }
+
+    if (network) {
+        dev->last_upload = now;
+    }
+    if (!network && !fetch_due && dev->pin == pin_before && leds_on(dev) == leds_before) {
+        dev->noop_wakes++;
+    }
+    return network;
+}
+
+// log_upload_due_hours() in main.c
+static int log_upload_due_hours(const device_t *dev, time_t now) {
+    if (HW_LOG_UPLOAD_INTERVAL_HOURS <= 0) {
+        return 0;
+    }
+    long remaining = (long)HW_LOG_UPLOAD_INTERVAL_HOURS * 3600;
+    if (dev->last_upload > 0 && now > dev->last_upload) {
+        remaining -= (long)(now - dev->last_upload);
+    }
+    int hours = (int)((remaining + 3599) / 3600);
+    return (hours < 1) ? 1 : hours;
+}
+
+// calculate_sleep_seconds() in main.c: next event hour at HH:00:30 local
+static time_t next_wake(device_t *dev, time_t now) {
+    struct tm local;
+    localtime_r(&now, &local);
+
+    wake_schedule_t schedule = {
+        .pin_on_hour = HW_PIN_ON_HOUR,
+        .pin_off_hour = dev->pin_off_hour,
+        .weather_check_hour = HW_WEATHER_CHECK_HOUR,
+        .log_upload_due_hours = log_upload_due_hours(dev, now),
+        .uploads_blocked = dev->uploads_blocked,
+    };
+    wake_plan_t plan;
+    wake_scheduler_next(&schedule, local.tm_hour, &plan);
+    dev->planned_events = plan.events;
+
+    local.tm_hour += plan.hours_ahead;
+    local.tm_min = 0;
+    local.tm_sec = WAKE_TARGET_SECOND;
+    local.tm_isdst = -1;
+    return mktime(&local);
+}
+
+// Returns the number of failures; with reevaluate false, mismatches are expected and counted instead.
+// With wifi_down, block_uploads false leaves upload wakes in the schedule, and no-op wakes are expected.
+static int run(const scenario_t *sc, bool reevaluate, bool wifi_down, bool block_uploads) {
+    struct tm first = {
+        .tm_year = sc->year - 1900, .tm_mon = sc->month - 1, .tm_mday = sc->day,
+        .tm_hour = 12, .tm_sec = WAKE_TARGET_SECOND, .tm_isdst = -1,
+    };
+    time_t start = mktime(&first);
+    time_t end = start + (time_t)sc->days * 86400;
+
+    device_t reference = {.pin_off_hour = DEFAULT_PIN_OFF_HOUR, .wifi_down = wifi_down};
+    device_t scheduled = reference;
+    scheduled.reevaluate_after_fetch = reevaluate;
+    scheduled.uploads_blocked = wifi_down && block_uploads;
+    time_t scheduled_wake = start;
+    time_t prev_upload = 0;
+    long max_gap = 0;
+    int wakes = 0, failures = 0, mismatches = 0;
+    int check_hours = 0, weather_wakes = 0;
+
+    // Every real hour is a wake of the reference (CET/CEST offsets are whole hours)
+    for (time_t now = start; now < end; now += 3600) {
+        int hour = local_hour(now);
+        wake(&reference, sc, start, now, false);
+
+        if (now == scheduled_wake) {
+            wakes++;
+            weather_wakes += (hour == HW_WEATHER_CHECK_HOUR) ? 1 : 0;
+            if (wake(&scheduled, sc, start, now, true)) {
+                if (prev_upload && now - prev_upload > max_gap) {
+                    max_gap = (long)(now - prev_upload);
+                }
+                prev_upload = now;
+            }
+
+            scheduled_wake = next_wake(&scheduled, now);
+            if (scheduled_wake <= now || (scheduled_wake - start) % 3600 != 0) {
+                struct tm tm;
+                localtime_r(&now, &tm);
+                printf("  %02d-%02d %02d:00 next wake not on an hour boundary (%+ld s)\n",
+                       tm.tm_mon + 1, tm.tm_mday, hour, (long)(scheduled_wake - now));
+                failures++;
+                break;
+            }
+        } else if (scheduled_wake < now) {
+            failures++;
+            break;
+        }
+
+        if (reference.pin != scheduled.pin || leds_on(&reference) != leds_on(&scheduled) ||
+            reference.pin_off_hour != scheduled.pin_off_hour) {
+            mismatches++;
+            if (reevaluate) {
+                struct tm tm;
+                localtime_r(&now, &tm);
+                printf("  %02d-%02d %02d:00 pin %d/%d, LEDs %d/%d, off at %d/%d (reference/scheduled)\n",
+                       tm.tm_mon + 1, tm.tm_mday, hour, reference.pin, scheduled.pin,
+                       leds_on(&reference), leds_on(&scheduled), reference.pin_off_hour, scheduled.pin_off_hour);
+                failures++;
+            }
+        }
+
+        if (hour == HW_WEATHER_CHECK_HOUR) {
+            check_hours++;
+        }
+    }
+
+    if (weather_wakes != check_hours) {
+        printf("  %d weather check wakes in %d days\n", weather_wakes, check_hours);
+        failures++;
+    }
+    if (HW_LOG_UPLOAD_INTERVAL_HOURS > 0 && !wifi_down && max_gap > (long)(HW_LOG_UPLOAD_INTERVAL_HOURS + 1) * 3600) {
+        failures++;
+    }
+
+    if (wifi_down && !block_uploads) {
+        printf("%-14s %04d-%02d-%02d: with log upload wakes still scheduled, %d no-op wakes  %s\n",
+               sc->name, sc->year, sc->month, sc->day, scheduled.noop_wakes, scheduled.noop_wakes ? "ok" : "FAIL");
+        return (scheduled.noop_wakes && !failures) ? 0 : 1;
+    }
+
+    if (!reevaluate) {
+        printf("%-14s %04d-%02d-%02d: without driving the outputs again after the fetch, %d hours differ  %s\n",
+               sc->name, sc->year, sc->month, sc->day, mismatches, mismatches ? "ok" : "FAIL");
+        return mismatches ? 0 : 1;
+    }
+
+    if (scheduled.noop_wakes) {
+        printf("  %d no-op wakes\n", scheduled.noop_wakes);
+        failures++;
+    }
+
+    if (wifi_down) {
+        printf("%-14s %04d-%02d-%02d: %d days, %d wakes (%.1f/day, hourly %d), %d fetches, no uploads  %s\n",
+               sc->name, sc->year, sc->month, sc->day, sc->days, wakes, (double)wakes / sc->days,
+               sc->days * 24, scheduled.fetches, failures ? "FAIL" : "ok");
+        return failures;
+    }
+    printf("%-14s %04d-%02d-%02d: %d days, %d wakes (%.1f/day, hourly %d), %d fetches, max upload gap %ld h  %s\n",
+           sc->name, sc->year, sc->month, sc->day, sc->days, wakes, (double)wakes / sc->days,
+           sc->days * 24, scheduled.fetches, max_gap / 3600, failures ? "FAIL" : "ok");
+    return failures;
+}
+
+int main(void) {
+    setenv("TZ", HW_TIMEZONE_POSIX, 1);
+    tzset();
+
+    // Off-hours from the cloudcover ranges, including the shortest and longest days
+    static const int summer[] = {17, 22, 18, 20, 19, 21, 17, 17};
+    static const int spring[] = {18, 19, 22, 17, 20};
+    static const int autumn[] = {17, 20, 18, 17, 22, 19};
+    static const int no_fetch_change[] = {17, 17, 17};
+    // Server decisions can move the pin-off hour across the check hour: off at once, then back on
+    static const int check_hour_change[] = {13, 20, 15, 17, 12, 21};
+
+    static const scenario_t scenarios[] = {
+        {"summer week", 2025, 6, 16, 8, summer},
+        {"spring DST", 2025, 3, 27, 5, spring},
+        {"autumn DST", 2025, 10, 23, 6, autumn},
+        {"constant", 2025, 1, 6, 3, no_fetch_change},
+        {"16:00 change", 2025, 5, 12, 6, check_hour_change},
+    };
+    static const scenario_t *const without_reevaluate = &scenarios[4];
+    // Forecasts come from the RTC cache while WiFi is down
+    static const scenario_t wifi_down = {"WiFi down", 2025, 6, 16, 8, summer};
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        failures += run(&scenarios[i], true, false, false);
+    }
+    failures += run(without_reevaluate, false, false, false);
+    failures += run(&wifi_down, true, true, true);
+    failures += run(&wifi_down, true, true, false);
+
+    printf("%s\n", failures ? "FAILED" : "All passed");
+    return failures ? 1 : 0;
+}
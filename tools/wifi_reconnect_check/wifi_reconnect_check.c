@@ -0,0 +1,93 @@
+/**
+ * Host check: WiFi reconnect policy
+ *
+ * Runs wifi_reconnect_decide() and wifi_reconnect_wake_allowed() through the
+ * cases wifi_helper.c relies on: wrong password and handshake failures give up
+ * at once, an AP that is not found gets one retry, transient failures retry
+ * with a 250 -> 500 -> 1000 -> 2000 ms backoff up to WIFI_RECONNECT_MAX_ATTEMPTS,
+ * and no retry is started that would end past the radio budget. It also
+ * replays a whole wake of repeated disconnects against HW_WIFI_RADIO_BUDGET_MS.
+ */
+
+#include "wifi_reconnect_policy.h"
+#include "hardware_config.h"
+#include <stdio.h>
+
+#define REASON_BEACON_TIMEOUT 200  // Transient (wifi_err_reason_t)
+#define REASON_ASSOC_FAIL     203  // Transient
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    printf("  %-60s %s\n", what, ok ? "ok" : "FAIL");
+    failures += ok ? 0 : 1;
+}
+
+static bool gives_up(wifi_reconnect_decision_t d) {
+    return d.action == WIFI_RECONNECT_GIVE_UP;
+}
+
+static bool retries_after(wifi_reconnect_decision_t d, uint32_t backoff_ms) {
+    return d.action == WIFI_RECONNECT_RETRY && d.backoff_ms == backoff_ms;
+}
+
+int main(void) {
+    printf("Reasons that give up at once\n");
+    check(gives_up(wifi_reconnect_decide(WIFI_RECONNECT_REASON_AUTH_EXPIRE, 0, 0, 0)), "AUTH_EXPIRE (wrong password)");
+    check(gives_up(wifi_reconnect_decide(WIFI_RECONNECT_REASON_4WAY_HANDSHAKE_TIMEOUT, 0, 0, 0)),
+          "4WAY_HANDSHAKE_TIMEOUT (wrong password)");
+    check(gives_up(wifi_reconnect_decide(WIFI_RECONNECT_REASON_AUTH_FAIL, 0, 0, 0)), "AUTH_FAIL");
+    check(gives_up(wifi_reconnect_decide(WIFI_RECONNECT_REASON_HANDSHAKE_TIMEOUT, 0, 0, 0)), "HANDSHAKE_TIMEOUT");
+
+    printf("AP not found\n");
+    check(retries_after(wifi_reconnect_decide(WIFI_RECONNECT_REASON_NO_AP_FOUND, 0, 0, 0), 250),
+          "first disconnect: retry after 250 ms");
+    check(gives_up(wifi_reconnect_decide(WIFI_RECONNECT_REASON_NO_AP_FOUND, WIFI_RECONNECT_NO_AP_ATTEMPTS, 0, 0)),
+          "after WIFI_RECONNECT_NO_AP_ATTEMPTS retries: give up");
+
+    printf("Transient failures\n");
+    static const uint32_t backoff[] = {250, 500, 1000, 2000, 2000};
+    for (int attempt = 0; attempt < WIFI_RECONNECT_MAX_ATTEMPTS; attempt++) {
+        char what[64];
+        snprintf(what, sizeof(what), "attempt %d: retry after %lu ms", attempt, (unsigned long)backoff[attempt]);
+        check(retries_after(wifi_reconnect_decide(REASON_BEACON_TIMEOUT, attempt, 0, 0), backoff[attempt]), what);
+    }
+    check(gives_up(wifi_reconnect_decide(REASON_BEACON_TIMEOUT, WIFI_RECONNECT_MAX_ATTEMPTS, 0, 0)),
+          "attempt WIFI_RECONNECT_MAX_ATTEMPTS: give up");
+    check(retries_after(wifi_reconnect_decide(REASON_ASSOC_FAIL, 1, 0, 0), 500), "ASSOC_FAIL is transient too");
+    check(retries_after(wifi_reconnect_decide(REASON_BEACON_TIMEOUT, -3, 0, 0), 250), "negative attempt treated as 0");
+
+    printf("Radio budget\n");
+    check(retries_after(wifi_reconnect_decide(REASON_BEACON_TIMEOUT, 0, 7749, 8000), 250),
+          "7749 ms + 250 ms < 8000 ms budget: retry");
+    check(gives_up(wifi_reconnect_decide(REASON_BEACON_TIMEOUT, 0, 7750, 8000)),
+          "7750 ms + 250 ms reaches the 8000 ms budget: give up");
+    check(gives_up(wifi_reconnect_decide(REASON_BEACON_TIMEOUT, 3, 6500, 8000)),
+          "6500 ms + 2000 ms backoff past the budget: give up");
+    check(retries_after(wifi_reconnect_decide(REASON_BEACON_TIMEOUT, 0, 100000, 0), 250), "budget 0: no cut-off");
+
+    // One wake: every connect attempt fails 1.5 s after it starts
+    printf("Replay of one wake (budget %d ms)\n", HW_WIFI_RADIO_BUDGET_MS);
+    uint32_t radio_on_ms = 1500;
+    int attempt = 0;
+    wifi_reconnect_decision_t d;
+    while (!gives_up(d = wifi_reconnect_decide(REASON_BEACON_TIMEOUT, attempt, radio_on_ms, HW_WIFI_RADIO_BUDGET_MS))) {
+        radio_on_ms += d.backoff_ms + 1500;
+        attempt++;
+    }
+    char what[64];
+    snprintf(what, sizeof(what), "gave up after %d retries, radio on %lu ms", attempt, (unsigned long)radio_on_ms);
+    check(attempt <= WIFI_RECONNECT_MAX_ATTEMPTS &&
+              radio_on_ms <= (uint32_t)HW_WIFI_RADIO_BUDGET_MS + 1500, what);
+
+    printf("Wakes after failed connects\n");
+    check(wifi_reconnect_wake_allowed(0, 3, false), "no failed wakes: allowed");
+    check(wifi_reconnect_wake_allowed(2, 3, false), "2 of 3 failed wakes: allowed");
+    check(!wifi_reconnect_wake_allowed(3, 3, false), "3 of 3 failed wakes: skipped");
+    check(!wifi_reconnect_wake_allowed(10, 3, false), "10 failed wakes: skipped");
+    check(wifi_reconnect_wake_allowed(10, 3, true), "10 failed wakes, weather fetch due: allowed");
+    check(wifi_reconnect_wake_allowed(1000, 0, false), "limit 0: always allowed");
+
+    printf("%s\n", failures ? "FAILED" : "All passed");
+    return failures ? 1 : 0;
+}